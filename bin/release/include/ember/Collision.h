@@ -0,0 +1,4 @@
+#include "sys/collision/Collider.h"
+#include "sys/collision/CollisionEngine.h"
+#include "sys/collision/SpatialPartition.h"
+#include "sys/collision/HandlesCollision.h"
@@ -0,0 +1,48 @@
+#ifndef Ember_BehaviourHooks_hpp
+#define Ember_BehaviourHooks_hpp
+
+#include <cstddef>
+#include <type_traits>
+
+#include "ember/core/Behaviour.hpp"
+
+namespace ember {
+
+/// BehaviourHooks detects, at compile time, which of the update cycle hooks (onPreUpdate, onUpdate, onPostUpdate) a behaviour type overrides.
+/// The Scene only dispatches each phase to behaviours overriding its hook, so pure data behaviours cost nothing per update cycle.
+/// A hook is assumed overridden whenever the detection can't tell (an override that isn't public, or an overloaded hook name).
+struct BehaviourHooks {
+    enum Phase : std::size_t { PreUpdate = 0, Update, PostUpdate, PhaseCount };
+    static constexpr unsigned All = (1u << PhaseCount) - 1;
+    static_assert(PhaseCount == Behaviour::hook_phase_count, "BehaviourHooks - Phase count must match the dispatch positions kept by Behaviour");
+
+    template <typename BehaviourSubType>
+    static constexpr unsigned OverriddenBy() {
+        return (decltype(OverridesPreUpdate<BehaviourSubType>(0))::value ? 1u << PreUpdate : 0u) |
+            (decltype(OverridesUpdate<BehaviourSubType>(0))::value ? 1u << Update : 0u) |
+            (decltype(OverridesPostUpdate<BehaviourSubType>(0))::value ? 1u << PostUpdate : 0u);
+    }
+
+private:
+    // A hook not overridden anywhere below Behaviour is still named as a member of Behaviour, through the subtype
+    template <typename BehaviourSubType>
+    static auto OverridesPreUpdate(int) ->
+        std::integral_constant<bool, !std::is_same<decltype(&BehaviourSubType::onPreUpdate), void (Behaviour::*)()>::value>;
+    template <typename BehaviourSubType>
+    static std::true_type OverridesPreUpdate(long);
+
+    template <typename BehaviourSubType>
+    static auto OverridesUpdate(int) ->
+        std::integral_constant<bool, !std::is_same<decltype(&BehaviourSubType::onUpdate), void (Behaviour::*)(double)>::value>;
+    template <typename BehaviourSubType>
+    static std::true_type OverridesUpdate(long);
+
+    template <typename BehaviourSubType>
+    static auto OverridesPostUpdate(int) ->
+        std::integral_constant<bool, !std::is_same<decltype(&BehaviourSubType::onPostUpdate), void (Behaviour::*)()>::value>;
+    template <typename BehaviourSubType>
+    static std::true_type OverridesPostUpdate(long);
+};
+
+}
+#endif
@@ -0,0 +1,163 @@
+#ifndef Ember_BehaviourType_hpp
+#define Ember_BehaviourType_hpp
+
+#include <cstdint>
+#include <cstddef>
+#include <typeinfo>
+#include <type_traits>
+
+/// Maximum number of distinct behaviour types a program may use. May be raised by defining it on the compiler command line,
+/// with the same value for the library and every program built against it.
+#ifndef EMBER_MAX_BEHAVIOUR_TYPES
+#define EMBER_MAX_BEHAVIOUR_TYPES 256
+#endif
+
+namespace ember {
+
+/// Dense id of a behaviour type, in [0, EMBER_MAX_BEHAVIOUR_TYPES).
+using BehaviourTypeId = std::uint32_t;
+
+/// BehaviourType assigns every behaviour type a dense id, the first time the id of that type is requested.
+/// Ids are used in place of std::type_index on the hot paths of GameObject, so that finding a behaviour is a bit test and an indexed load.
+/// Ids are only stable within a single run of the program, and must not be stored or sent anywhere (snapshots carry SnapshotTags instead).
+/// Cv-qualified types share the id of the unqualified type, so 'Id<const Position>()' is 'Id<Position>()'.
+class BehaviourType {
+public:
+    template <typename BehaviourSubType>
+    static BehaviourTypeId Id() {
+        return UnqualifiedId<typename std::remove_cv<BehaviourSubType>::type>();
+    }
+
+    /// Number of behaviour types registered so far.
+    static std::size_t Count();
+
+    /// Type information of the behaviour type with the provided id, for diagnostics.
+    static const std::type_info& Info(BehaviourTypeId id);
+
+private:
+    template <typename BehaviourSubType>
+    static BehaviourTypeId UnqualifiedId() {
+        static const BehaviourTypeId id = Register(typeid(BehaviourSubType));
+        return id;
+    }
+
+    // Throws std::length_error if more than EMBER_MAX_BEHAVIOUR_TYPES types are registered
+    static BehaviourTypeId Register(const std::type_info& info);
+};
+
+/// BehaviourMask is a fixed size bitset of behaviour type ids, used by GameObjects to record which behaviour types they hold.
+class BehaviourMask {
+    friend class SubtypeRegistry;
+public:
+    static constexpr std::size_t capacity = EMBER_MAX_BEHAVIOUR_TYPES;
+
+    inline bool test(BehaviourTypeId id) const { return (_words[id / 64] >> (id % 64) & 1) != 0; }
+    inline void set(BehaviourTypeId id) { _words[id / 64] |= std::uint64_t(1) << (id % 64); }
+    inline void reset(BehaviourTypeId id) { _words[id / 64] &= ~(std::uint64_t(1) << (id % 64)); }
+
+    /// Number of ids set in the mask that are lower than 'id'.
+    inline std::size_t rank(BehaviourTypeId id) const {
+        std::size_t rank = 0;
+        for (std::size_t word = 0; word < id / 64; word++) {
+            rank += PopCount(_words[word]);
+        }
+        return rank + PopCount(_words[id / 64] & ((std::uint64_t(1) << (id % 64)) - 1));
+    }
+
+    inline std::size_t count() const {
+        std::size_t count = 0;
+        for (auto word : _words) {
+            count += PopCount(word);
+        }
+        return count;
+    }
+
+    inline bool none() const {
+        for (auto word : _words) {
+            if (word != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// True if every id set in 'other' is also set in this mask.
+    inline bool contains(const BehaviourMask& other) const {
+        for (std::size_t word = 0; word < word_count; word++) {
+            if ((_words[word] & other._words[word]) != other._words[word]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// True if any id is set in both masks.
+    inline bool intersects(const BehaviourMask& other) const {
+        for (std::size_t word = 0; word < word_count; word++) {
+            if ((_words[word] & other._words[word]) != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// Calls 'fun(BehaviourTypeId)' for every id set in the mask, in increasing order.
+    template <typename Function>
+    void forEach(Function&& fun) const {
+        for (std::size_t word = 0; word < word_count; word++) {
+            for (auto bits = _words[word]; bits != 0; bits &= bits - 1) {
+                fun(static_cast<BehaviourTypeId>(word * 64 + LowestBit(bits)));
+            }
+        }
+    }
+
+    friend inline bool operator==(const BehaviourMask& lhs, const BehaviourMask& rhs) {
+        for (std::size_t word = 0; word < word_count; word++) {
+            if (lhs._words[word] != rhs._words[word]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    friend inline bool operator!=(const BehaviourMask& lhs, const BehaviourMask& rhs) { return !(lhs == rhs); }
+    friend inline bool operator<(const BehaviourMask& lhs, const BehaviourMask& rhs) {
+        for (std::size_t word = 0; word < word_count; word++) {
+            if (lhs._words[word] != rhs._words[word]) {
+                return lhs._words[word] < rhs._words[word];
+            }
+        }
+        return false;
+    }
+
+private:
+    static constexpr std::size_t word_count = (capacity + 63) / 64;
+
+    static inline std::size_t PopCount(std::uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<std::size_t>(__builtin_popcountll(bits));
+#else
+        std::size_t count = 0;
+        for (; bits != 0; bits &= bits - 1) {
+            count++;
+        }
+        return count;
+#endif
+    }
+
+    static inline std::size_t LowestBit(std::uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<std::size_t>(__builtin_ctzll(bits));
+#else
+        std::size_t index = 0;
+        for (; (bits & 1) == 0; bits >>= 1) {
+            index++;
+        }
+        return index;
+#endif
+    }
+
+    std::uint64_t _words[word_count] = {};
+};
+
+}
+#endif
@@ -0,0 +1,84 @@
+#ifndef Ember_ChangeJournal_hpp
+#define Ember_ChangeJournal_hpp
+
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+
+namespace ember {
+
+class Behaviour;
+class ChangeJournal;
+
+/// A JournalEntry is a value held by a behaviour, whose changes are versioned, and recorded in the ChangeJournal of the behaviour's scene
+/// (see addons::VersionedValue). Versions come from a single counter shared by every entry in the process, so any version can be compared
+/// against any other: an entry changed since version N if its version is greater than N.
+class JournalEntry {
+    friend class ChangeJournal;
+public:
+    explicit JournalEntry(Behaviour& owner) : _owner(&owner) {}
+    JournalEntry(const JournalEntry& other) = delete;
+    JournalEntry& operator=(const JournalEntry& other) = delete;
+    ~JournalEntry();
+
+public:
+    /// Version of the entry's latest change, 0 if it never changed.
+    inline std::uint64_t version() const { return _version.load(std::memory_order_acquire); }
+    inline bool changed_since(std::uint64_t version) const { return this->version() > version; }
+
+    /// The behaviour holding the entry.
+    inline Behaviour& owner() const { return *_owner; }
+
+    /// The latest version handed out to any entry. Remembering it, and later asking for the changes since, yields every change in between.
+    static std::uint64_t CurrentVersion();
+
+protected:
+    /// Gives the entry a new version, and moves it to the end of its scene's journal. Safe to call from any thread.
+    void RecordChange();
+
+private:
+    Behaviour* _owner;
+    std::atomic<std::uint64_t> _version{ 0 };
+    // Links of the journal the entry is in, if any
+    ChangeJournal* _journal = nullptr;
+    JournalEntry* _previous = nullptr;
+    JournalEntry* _next = nullptr;
+};
+
+/// A ChangeJournal lists the entries of a scene that changed, each once, in the order of their latest change, so the entries changed since a
+/// version are found without visiting the others (see Scene::forEachChangeSince). Entries leave the journal when destroyed.
+class ChangeJournal {
+    friend class JournalEntry;
+public:
+    ChangeJournal() = default;
+    ChangeJournal(const ChangeJournal& other) = delete;
+    ChangeJournal& operator=(const ChangeJournal& other) = delete;
+    ~ChangeJournal();
+
+public:
+    /// Calls 'fun(JournalEntry&)' on every entry changed since 'version', from the earliest change to the latest.
+    /// Must not run while entries are being changed, or destroyed.
+    template <typename Function>
+    void forEachChangeSince(std::uint64_t version, Function&& fun) const {
+        auto entry = _tail;
+        while (entry != nullptr && entry->_previous != nullptr && entry->_previous->version() > version) {
+            entry = entry->_previous;
+        }
+        for (; entry != nullptr; entry = entry->_next) {
+            if (entry->version() > version) {
+                fun(*entry);
+            }
+        }
+    }
+
+private:
+    void Record(JournalEntry& entry);
+    void Unlink(JournalEntry& entry);
+
+    std::mutex _mutex;
+    JournalEntry* _head = nullptr;
+    JournalEntry* _tail = nullptr;
+};
+
+}
+#endif
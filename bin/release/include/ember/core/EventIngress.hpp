@@ -0,0 +1,127 @@
+#ifndef Ember_EventIngress_hpp
+#define Ember_EventIngress_hpp
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "ember/core/SlotMap.hpp"
+
+namespace ember {
+
+/// Counters describing the state of an EventIngress, and the traffic through it.
+struct EventIngressStats {
+    std::size_t capacity = 0;
+    /// Events posted but not yet drained
+    std::size_t depth = 0;
+    /// Highest depth found when draining, since the ingress was created
+    std::size_t peak_depth = 0;
+    std::size_t posted = 0;
+    std::size_t drained = 0;
+    /// Events turned away because the ingress was full
+    std::size_t rejected = 0;
+};
+
+/// EventIngress is a bounded, lock free, multiple producer single consumer queue of events of any type, through which threads other than the
+/// one running a Scene hand events over to it (see Scene::PostEvent).
+/// Events are copied into fixed size cells of a ring buffer, allocated once; only events larger than 'inline_event_size' are allocated separately.
+/// When the ring is full, posting fails instead of blocking or growing, leaving the producer to decide what to do (backpressure).
+class EventIngress {
+public:
+    static constexpr std::size_t inline_event_size = 48;
+    static constexpr std::size_t default_capacity = 1024;
+
+    /// Called on each drained event, with the target it was posted for (null if broadcast), and the context passed to Drain.
+    using Consumer = void (*)(void* event, SlotHandle target, void* context);
+
+    /// 'capacity' is rounded up to a power of two.
+    explicit EventIngress(std::size_t capacity = default_capacity);
+    ~EventIngress();
+    EventIngress(const EventIngress& other) = delete;
+    EventIngress& operator=(const EventIngress& other) = delete;
+
+public:
+    /// Posts a copy of 'event', to be handed to 'consume' when drained. Returns false, without posting, if the ingress is full.
+    /// Safe to call from any number of threads at once.
+    template <typename EventType>
+    bool Post(SlotHandle target, const EventType& event, Consumer consume);
+
+    /// Hands every event posted so far to its consumer, in the order they were posted, and returns how many there were.
+    /// Must only be called from one thread at a time.
+    std::size_t Drain(void* context);
+
+    EventIngressStats stats() const;
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        typename std::aligned_storage<inline_event_size, alignof(std::max_align_t)>::type storage;
+        void* event;
+        Consumer consume;
+        void (*destroy)(void* event, bool allocated);
+        bool allocated;
+        SlotHandle target;
+    };
+
+    template <typename EventType>
+    static void* Construct(Cell& cell, const EventType& event, std::true_type /*stored inline*/) { return new (&cell.storage) EventType(event); }
+    template <typename EventType>
+    static void* Construct(Cell&, const EventType& event, std::false_type /*stored inline*/) { return new EventType(event); }
+    template <typename EventType>
+    static void Destroy(void* event, bool allocated) {
+        if (allocated) {
+            delete static_cast<EventType*>(event);
+        } else {
+            static_cast<EventType*>(event)->~EventType();
+        }
+    }
+
+    // Claims the next cell, or returns nullptr if the ring is full
+    Cell* Claim(std::size_t& position);
+    // Hands the claimed cell over to the consumer
+    inline void Publish(Cell& cell, std::size_t position) { cell.sequence.store(position + 1, std::memory_order_release); }
+
+    const std::size_t _mask;
+    std::unique_ptr<Cell[]> _cells;
+    // Producers and the consumer move through the ring on separate cache lines. Padded rather than aligned, as C++14 can't allocate over-aligned types
+    char _padding_before_enqueue[64];
+    std::atomic<std::size_t> _enqueue_position{ 0 };
+    char _padding_before_dequeue[64 - sizeof(std::atomic<std::size_t>)];
+    std::size_t _dequeue_position = 0;
+    char _padding_before_counters[64 - sizeof(std::size_t)];
+    // Posted events are counted by '_enqueue_position', so producers only update a counter when rejected
+    std::atomic<std::size_t> _drained{ 0 };
+    std::atomic<std::size_t> _peak_depth{ 0 };
+    std::atomic<std::size_t> _rejected{ 0 };
+};
+
+template <typename EventType>
+bool EventIngress::Post(SlotHandle target, const EventType& event, Consumer consume) {
+    std::size_t position;
+    auto cell = Claim(position);
+    if (cell == nullptr) {
+        _rejected.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    using StoredInline = std::integral_constant<bool, sizeof(EventType) <= inline_event_size && alignof(EventType) <= alignof(std::max_align_t)>;
+    cell->allocated = !StoredInline::value;
+    try {
+        cell->event = Construct(*cell, event, StoredInline());
+    } catch (...) {
+        // The cell is already claimed, and must be published for the consumer to move past it, empty
+        cell->consume = nullptr;
+        Publish(*cell, position);
+        throw;
+    }
+    cell->consume = consume;
+    cell->destroy = &Destroy<EventType>;
+    cell->target = target;
+    Publish(*cell, position);
+    return true;
+}
+
+}
+#endif
@@ -0,0 +1,61 @@
+#ifndef Ember_EventQueue_hpp
+#define Ember_EventQueue_hpp
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "ember/core/SlotMap.hpp"
+
+namespace ember {
+
+class Scene;
+
+/// EventQueueBase is the type erased interface the Scene keeps its queues of events through, one per event type (see Scene::QueueEvent).
+/// Each queue is double buffered: events queued while a flush is delivering go to the other buffer, and wait for the next flush.
+class EventQueueBase {
+public:
+    virtual ~EventQueueBase() = default;
+
+    /// Dense id of an event type, assigned the first time it's requested, used to index the scene's queues.
+    template <typename EventType>
+    static std::size_t TypeId() {
+        static const std::size_t id = NextTypeId();
+        return id;
+    }
+
+    /// Moves the events queued so far to the buffers being delivered, returning false if there were none.
+    /// Must be called with the scene's queue lock held.
+    virtual bool TakeQueued() = 0;
+
+    /// Delivers the events moved by the last call to TakeQueued, in bulk, to the listeners in 'scene'.
+    virtual void Deliver(Scene& scene) = 0;
+
+private:
+    static std::size_t NextTypeId();
+};
+
+/// Queue of the events of one type, both broadcast to the scene and targeted at single objects.
+/// Queueing is not synchronized here, the scene serializes it.
+template <typename EventType>
+class EventQueue final : public EventQueueBase {
+public:
+    inline void Queue(const EventType& event) { _broadcast.push_back(event); }
+    inline void Queue(SlotHandle target, const EventType& event) { _targeted.emplace_back(target, event); }
+    inline bool empty() const { return _broadcast.empty() && _targeted.empty(); }
+
+    bool TakeQueued() override;
+    void Deliver(Scene& scene) override;
+
+private:
+    std::vector<EventType> _broadcast;
+    std::vector<std::pair<SlotHandle, EventType>> _targeted;
+    // Buffers being delivered, swapped with the ones above on every flush, keeping the capacity of both
+    std::vector<EventType> _delivering_broadcast;
+    std::vector<std::pair<SlotHandle, EventType>> _delivering_targeted;
+    // Targeted events, grouped by target, so each target gets its events as one contiguous span
+    std::vector<EventType> _grouped_events;
+};
+
+}
+#endif
@@ -0,0 +1,172 @@
+#ifndef GameObject_hpp
+#define GameObject_hpp
+
+#include <vector>
+#include <map>
+#include <atomic>
+#include <thread>
+#include <memory>
+#include <iostream>
+#include <typeinfo>
+#include <typeindex>
+
+#include "ember/core/SlotMap.hpp"
+#include "ember/core/PoolAllocator.hpp"
+#include "ember/core/BehaviourType.hpp"
+#include "ember/core/SubtypeRegistry.hpp"
+#include "ember/addons/ListensTo.hpp"
+#include "ember/addons/Serializable.hpp"
+
+namespace ember {
+class Behaviour;
+class Scene;
+class Archetype;
+
+/// The Gameobject is one of the essential building blocks of Ember. In it's essence, it's purpose is to exist as an
+/// aggregate of behaviours, modifying itself, and others based solely on the behaviours it contains, and follows.
+/// The GameObject class is meant to be used in conjunction with the Scene and Behaviours, but like the Scene, it's should not be subclassed or modified.
+class GameObject {
+    friend class Scene;
+    friend class Archetype;
+    friend class QueryIndex;
+    friend class Behaviour;
+public:
+    /// Type that defined the id of a GameObject. Identifies a gameobject as unique inside a scene.
+    /// The id is a generational handle into the scene's object storage, so ids of destroyed objects are never mistaken for
+    /// objects that are later created in the same storage slot.
+    using id = SlotHandle;
+
+public:
+	GameObject();
+	GameObject(GameObject&& other);
+	GameObject(const GameObject& other) = delete;
+    GameObject& operator=(const GameObject& other) = delete;
+	GameObject& operator=(GameObject&& other);
+	~GameObject();
+
+public:
+    inline GameObject::id object_id() const { return _id; }
+    inline Scene& scene() { return *_parent_scene; }
+    inline const Scene& scene() const { return *_parent_scene; }
+
+    /// Mask of the type ids of every behaviour held by the object (see BehaviourType.hpp).
+    inline const BehaviourMask& behaviour_mask() const { return _behaviour_mask; }
+
+    /// Adds a behaviour to the GameObject. The Behaviour is emplaced within the game object itself.
+    /// Behaviours are allocated from a pool per behaviour type, reused as behaviours are destroyed (see Scene::reserveBehaviours).
+    /// A Behaviour can be any class that derives from Behaviour.hpp, but should not be the base heaviour class itself.
+    /// Only one behaviour of each type may reside inside a GameObject. If a second one is atempted to added, the function will have no effect.
+    /// If called on an object already in the scene while an update phase is running, the behaviour is constructed immediately, but only attached
+    /// to the object once the phase ends (see Scene::addGameObject).
+	template <typename BehaviourSubType, typename... Args>
+	GameObject& withBehaviour(Args&&... args);
+
+    /// Checks if the Game Object has a behaviour of the specified type (non-polymorphic, only accounts for behaviours of the exact type provided)
+    /// A single bit test.
+    template <typename BehaviourSubType>
+	bool hasBehaviour() const;
+
+    /// Fetches a non-polymorphic reference to a contained behaviour in the GameObject.
+    /// Throws an exception if no such behaviour is present. Constant time.
+    /// Usefull to quickly access the behaviour as an expression, but unsafe to keep, as it may be unexpectedly destroyed.
+    template <typename BehaviourSubType>
+	BehaviourSubType& refBehaviour() throw(std::invalid_argument);
+    template <typename BehaviourSubType>
+	const BehaviourSubType& refBehaviour() const throw(std::invalid_argument);
+
+    /// Gets a non-polymorphic weak pointer to a contained behaviour in the GameObject.
+    /// Returns expired weak_ptr if no such behaviour is present.
+    /// Usefull if you need to keep a safe pointer to the behaviour, to check if it still exists,
+    ///  or to potentially lock it for access post GameObject destruction.
+    template <typename BehaviourSubType>
+	std::weak_ptr<BehaviourSubType> getBehaviour();
+    template <typename BehaviourSubType>
+    std::weak_ptr<const BehaviourSubType> getBehaviour() const;
+
+    /// Gets all weak pointers of behaviours that either are a BehaviourType or subclasses of it.
+    /// Usefull if you need to fetch all behaviours with a common parent, such as behaviour addons (for example, SerializableInto's).
+    /// Allocates the returned vector, use forEachBehaviour or hasBehaviours if you don't need to keep the pointers,
+    ///   or refBehaviour/getBehaviour if you are trying to reach a specific behaviour.
+    template <typename BehaviourSubType>
+	std::vector<std::weak_ptr<BehaviourSubType>> getBehaviours();
+    template <typename BehaviourSubType>
+    std::vector<std::weak_ptr<const BehaviourSubType>> getBehaviours() const;
+
+    /// Checks if the GameObject has any behaviour that either is a BehaviourSubType or a subclass of it.
+    /// The first time a behaviour type is checked against BehaviourSubType it's resolved through a dynamic_cast, after that it's a mask intersection
+    /// (see SubtypeRegistry.hpp).
+    template <typename BehaviourSubType>
+    bool hasBehaviours() const;
+
+    /// Calls 'fun(BehaviourSubType&)' on every behaviour that either is a BehaviourSubType or a subclass of it, in behaviour type id order.
+    /// Doesn't allocate, nor cast through RTTI once the behaviour types are resolved (see hasBehaviours).
+    template <typename BehaviourSubType, typename Function>
+    void forEachBehaviour(Function&& fun);
+    template <typename BehaviourSubType, typename Function>
+    void forEachBehaviour(Function&& fun) const;
+
+    /// Triggers an event through all the child behaviours that have the ListenTo Addon (are subclasses of ListenTo<EventType>)
+    /// Only the listeners are visited, found through the subtype registry of ListenTo<EventType>, without RTTI once their types are resolved.
+    /// Wakes the object up if it's sleeping (collisions reach objects as events, so they wake them up as well).
+    template <typename EventType>
+	void CastEvent(const EventType& event);
+
+    /// Queues an event for the object's listeners, delivered in bulk at the scene's next event flush point (see Scene::QueueEvent), waking the
+    /// object up then if it's sleeping. Nothing is delivered if the object no longer exists by then. Safe to call from any thread.
+    template <typename EventType>
+    void QueueEvent(const EventType& event);
+
+    /// Puts the object to sleep. A sleeping object costs nothing per update cycle: the update hooks of its behaviours aren't called, and systems
+    /// don't visit it, until it's woken up, either through Wake or by an event cast on it. It keeps its place in the scene and in every system it
+    /// was filtered into, and still receives broadcast events, without waking. Behaviours attached while it sleeps only start updating once it wakes.
+    /// Inside an update phase, the object falls asleep (or wakes up) once the phase ends.
+    void Sleep();
+    void Wake();
+    inline bool isSleeping() const { return _sleeping; }
+
+    /// Serializes the gameobject into the object of the data type provided.
+    /// Serialization works by going through all of the gameobjects contained behaviours and attemtping to serialize them to this datatype
+    /// As long as at least one behaviour is able to serialize itself successfully, this method will return true, and the serializations will be contained in
+    /// 'into'.
+    /// Serializations are cached until further changes. This means that if this method is called several times, internally,
+    /// The behaviours serialization functions will only be called again if the behaviours indicate that something in their internal state has changed.
+    /// Behaviours indicate changes by calling Behaviour::MarkSerializationDirty (or through bound DirtyValues). Those that didn't declare they
+    /// report every change (see Behaviour::setReportsSerializationChanges) are also asked through IsSerializationDirty as each update cycle ends,
+    /// for the objects holding caches they're responsible for. Nothing is checked for objects not serialized.
+    /// When nothing is cached, the behaviours serialize into 'into' itself, on top of what it already holds, and the cache is copied from it.
+    /// Otherwise 'into' is assigned a copy of the cached serialization. The type must be copy constructible and copy assignable.
+    template <typename SerializableInto>
+    bool SerializeInto(SerializableInto& into);
+
+    /// Equal to the above function, but won't contain the full serialization of the GameObject. Behaviours can define partial serializations (usually only with
+    /// mission critical data, or only with a change set since the previous serialization call). This method will call those partial serialization methods.
+    template <typename SerializableInto>
+    bool PartialSerializeInto(SerializableInto& into);
+
+    /// Equal to SerializeInto, but instead of copying the serialization into an object of the caller, returns the cached serialization itself,
+    /// shared and immutable, or null if no behaviour could serialize itself. Every caller within a cycle shares the same object, and a
+    /// miss serializes the behaviours straight into it, so neither copies the serialization. The object returned is never modified: once the
+    /// behaviours change, the cache is replaced, and the readers still holding the previous serialization keep it intact.
+    /// Safe to call on the same object from several threads at once (see Scene::serializeGameObjects), as long as the behaviours' serialization
+    /// functions don't touch other objects. They may serialize their own object into other types. The behaviours serialize into a default constructed object, so the type must be default constructible.
+    template <typename SerializableType>
+    std::shared_ptr<const SerializableType> SerializeShared();
+
+    /// Equal to PartialSerializeInto, sharing the cached partial serialization as SerializeShared does. Null if nothing was serialized.
+    template <typename SerializableType>
+    std::shared_ptr<const SerializableType> PartialSerializeShared();
+
+    /// Removes GameObject from scene and deallocates it.
+    /// Keep in mind that Scene guarantees that Object/Behaviour deletion will ONLY happen in between Update Cycle callbacks
+    /// what this means, for example, is that it's safe to delete objects at any time inside those callbacks.
+    /// In a behaviour, on the 'onPreUpdate', 'onUpdate', 'onPostUpdate' calls, if you call Destroy (or Scene::removeGameObject, which is equivalent)
+    /// then you can be sure that the object will only actually be deleted after that update cycle callback itself is called on every other GameObject.
+    void Destroy();
+
+    // Private members of GameObject contained in header
+    #include "_priv/GameObject_priv.hpp"
+};
+}
+#include "_impl/GameObject_impl.hpp"
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef Ember_Query_hpp
+#define Ember_Query_hpp
+
+#include <array>
+#include <tuple>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "ember/core/SlotMap.hpp"
+#include "ember/core/BehaviourType.hpp"
+#include "ember/core/Behaviour.hpp"
+
+namespace ember {
+
+class GameObject;
+
+/// A QueryIndex holds every awake object of a scene that has a behaviour of each of a set of types, together with pointers to those behaviours.
+/// Indices are created by the Scene the first time a set of types is queried (see Scene::query), and kept up to date from then on as objects
+/// join, leave, sleep, wake, or gain behaviours, so iterating one never scans the scene, nor looks behaviours up.
+/// Rows are unordered: removing an object moves the last row into its place.
+class QueryIndex {
+    friend class Scene;
+public:
+    explicit QueryIndex(const BehaviourMask& required) : _required(required), _stride(required.count()) {}
+    QueryIndex(const QueryIndex& other) = delete;
+    QueryIndex& operator=(const QueryIndex& other) = delete;
+
+public:
+    /// The behaviour types every object in the index holds. Each row holds one behaviour per type, in increasing type id order.
+    inline const BehaviourMask& required() const { return _required; }
+
+    /// Number of objects in the index.
+    inline std::size_t size() const { return _object_ids.size(); }
+
+    inline SlotHandle object_id(std::size_t row) const { return _object_ids[row]; }
+    inline Behaviour* behaviour(std::size_t row, std::size_t column) const { return _behaviours[row * _stride + column]; }
+
+private:
+    inline bool Contains(SlotHandle object_id) const {
+        return object_id.index < _rows_by_slot.size() && _rows_by_slot[object_id.index] != npos && _object_ids[_rows_by_slot[object_id.index]] == object_id;
+    }
+
+    // Appends the object, which must hold every required type and not be in the index yet
+    void Insert(const GameObject& object);
+    // Removes the object if it's in the index
+    void Remove(SlotHandle object_id);
+
+    static constexpr std::uint32_t npos = static_cast<std::uint32_t>(-1);
+
+    BehaviourMask _required;
+    std::size_t _stride;
+    std::vector<SlotHandle> _object_ids;
+    // '_stride' behaviours per row
+    std::vector<Behaviour*> _behaviours;
+    // Row of each object, by the index of its storage slot
+    std::vector<std::uint32_t> _rows_by_slot;
+};
+
+/// A Query is a view over the QueryIndex of a set of behaviour types, yielding references to the behaviours of each object, typed and in the
+/// order the types were listed. Obtained through Scene::query; cheap to copy, and valid for as long as the scene exists.
+/// Iterating allocates nothing, and involves no lookups, locks nor casts through RTTI. The scene must not add or remove objects, behaviours,
+/// or put objects to sleep outside of an update phase while a query is being iterated (within phases, those changes are deferred).
+template <typename... BehaviourTypes>
+class Query {
+    static_assert(sizeof...(BehaviourTypes) != 0, "Query - At least one behaviour type must be provided");
+    using Columns = std::array<std::size_t, sizeof...(BehaviourTypes)>;
+public:
+    using value_type = std::tuple<BehaviourTypes&...>;
+
+    class iterator {
+    public:
+        iterator(const QueryIndex* index, const Columns& columns, std::size_t row) : _index(index), _columns(columns), _row(row) {}
+
+        inline value_type operator*() const { return Row(std::index_sequence_for<BehaviourTypes...>()); }
+        inline iterator& operator++() { _row++; return *this; }
+        inline bool operator==(const iterator& other) const { return _row == other._row; }
+        inline bool operator!=(const iterator& other) const { return _row != other._row; }
+
+        /// Id of the object the current row belongs to.
+        inline SlotHandle object_id() const { return _index->object_id(_row); }
+
+    private:
+        template <std::size_t... Indices>
+        inline value_type Row(std::index_sequence<Indices...>) const {
+            return value_type(static_cast<BehaviourTypes&>(*_index->behaviour(_row, _columns[Indices]))...);
+        }
+
+        const QueryIndex* _index;
+        Columns _columns;
+        std::size_t _row;
+    };
+
+    explicit Query(const QueryIndex& index) : _index(&index) {
+        std::size_t type = 0;
+        int expand[] = { 0, (_columns[type++] = index.required().rank(BehaviourType::Id<BehaviourTypes>()), 0)... };
+        (void)expand;
+    }
+
+    inline std::size_t size() const { return _index->size(); }
+    inline bool empty() const { return _index->size() == 0; }
+    inline iterator begin() const { return iterator(_index, _columns, 0); }
+    inline iterator end() const { return iterator(_index, _columns, _index->size()); }
+
+    /// Calls 'fun(BehaviourTypes&...)' for every object in the query.
+    template <typename Function>
+    void forEach(Function&& fun) const {
+        ForEach(fun, std::index_sequence_for<BehaviourTypes...>());
+    }
+
+private:
+    template <typename Function, std::size_t... Indices>
+    void ForEach(Function& fun, std::index_sequence<Indices...>) const {
+        const std::size_t size = _index->size();
+        for (std::size_t row = 0; row < size; row++) {
+            fun(static_cast<BehaviourTypes&>(*_index->behaviour(row, _columns[Indices]))...);
+        }
+    }
+
+    const QueryIndex* _index;
+    Columns _columns;
+};
+
+}
+#endif
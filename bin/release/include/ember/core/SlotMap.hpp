@@ -0,0 +1,311 @@
+#ifndef Ember_SlotMap_hpp
+#define Ember_SlotMap_hpp
+
+#include <cstdint>
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <vector>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+
+namespace ember {
+
+/// SlotHandle is a generational handle into a SlotMap. It's formed by the index of the slot the value lives in, and the
+/// generation of that slot at the time the value was inserted. Once the value is erased the slot generation moves on, so any
+/// handle still pointing at it is detected as stale, even if the slot has since been reused.
+/// A default constructed handle is null, and will never match any value.
+struct SlotHandle {
+    std::uint32_t index = 0;
+    std::uint32_t generation = 0;
+
+    inline bool is_null() const { return generation == 0; }
+};
+
+inline bool operator==(const SlotHandle& lhs, const SlotHandle& rhs)
+    { return lhs.index == rhs.index && lhs.generation == rhs.generation; }
+inline bool operator!=(const SlotHandle& lhs, const SlotHandle& rhs)
+    { return !(lhs == rhs); }
+inline bool operator<(const SlotHandle& lhs, const SlotHandle& rhs)
+    { return lhs.index < rhs.index || (lhs.index == rhs.index && lhs.generation < rhs.generation); }
+
+
+/// SlotMap is a generational container, used by the Scene to store its GameObjects.
+/// Values are constructed in place inside fixed size pages of slots, so they never move once inserted (references to them remain valid
+/// until they are erased), while still being laid out contiguously for linear iteration.
+/// Lookups through a SlotHandle are O(1), and erased slots are reused through a free list.
+/// Lookups (contains/get) are safe to perform from any thread while a single thread inserts or erases values, as long as no thread
+/// looks up a value while it's being erased. Iteration and every other operation must not run concurrently with insertions or erasures.
+template <typename ValueType, std::size_t PageSize = 1024>
+class SlotMap {
+    struct Slot {
+        // Odd while the slot holds a value, even while it's free. Handles are only ever given out with odd generations.
+        std::atomic<std::uint32_t> generation{ 0 };
+        typename std::aligned_storage<sizeof(ValueType), alignof(ValueType)>::type storage;
+
+        inline bool alive() const { return (generation.load(std::memory_order_relaxed) & 1) != 0; }
+        inline ValueType* value() { return reinterpret_cast<ValueType*>(&storage); }
+        inline const ValueType* value() const { return reinterpret_cast<const ValueType*>(&storage); }
+    };
+
+    // Table of page pointers read by concurrent lookups. When it runs out of room a bigger copy is published in its place, while the
+    // old table is kept alive (until the map is destroyed) for any lookup still reading it.
+    struct PageTable {
+        explicit PageTable(std::size_t page_capacity) : capacity(page_capacity), pages(new std::atomic<Slot*>[page_capacity]) {
+            for (std::size_t index = 0; index < capacity; index++) {
+                pages[index].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+        std::size_t capacity;
+        std::unique_ptr<std::atomic<Slot*>[]> pages;
+    };
+
+public:
+    using handle = SlotHandle;
+
+    template <typename MapType, typename Reference>
+    class Iterator {
+        friend class SlotMap;
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = ValueType;
+        using difference_type = std::ptrdiff_t;
+        using pointer = typename std::remove_reference<Reference>::type*;
+        using reference = Reference;
+
+        Reference operator*() const { return *_map->slot(_index).value(); }
+        pointer operator->() const { return _map->slot(_index).value(); }
+        Iterator& operator++() { _index = _map->next_alive(_index + 1); return *this; }
+        Iterator operator++(int) { Iterator copy(*this); ++(*this); return copy; }
+        bool operator==(const Iterator& other) const { return _index == other._index; }
+        bool operator!=(const Iterator& other) const { return _index != other._index; }
+
+    private:
+        Iterator(MapType* map, std::uint32_t index) : _map(map), _index(index) {}
+        MapType* _map;
+        std::uint32_t _index;
+    };
+    using iterator = Iterator<SlotMap, ValueType&>;
+    using const_iterator = Iterator<const SlotMap, const ValueType&>;
+
+public:
+    SlotMap() = default;
+    SlotMap(const SlotMap& other) = delete;
+    SlotMap& operator=(const SlotMap& other) = delete;
+    SlotMap(SlotMap&& other) { swap(other); }
+    SlotMap& operator=(SlotMap&& other) { swap(other); return *this; }
+    ~SlotMap() { clear(); }
+
+    /// Constructs a new value in place, reusing a free slot if one is available, and returns the handle to it.
+    template <typename... Args>
+    handle emplace(Args&&... args) {
+        std::uint32_t index;
+        if (!_free_indices.empty()) {
+            index = _free_indices.back();
+            _free_indices.pop_back();
+        } else {
+            if (_slot_count == capacity()) {
+                add_page();
+            }
+            index = static_cast<std::uint32_t>(_slot_count++);
+        }
+        Slot& new_slot = slot(index);
+        new (&new_slot.storage) ValueType(std::forward<Args>(args)...);
+        auto generation = new_slot.generation.load(std::memory_order_relaxed) + 1;
+        new_slot.generation.store(generation, std::memory_order_release);
+        _size++;
+        return handle{index, generation};
+    }
+
+    /// Destroys the value the handle points to. Returns false if the handle was stale.
+    /// The slot is marked as dead before the value is destroyed, and only freed for reuse after the destructor returns, so a
+    /// value is free to use the map while it is being destroyed.
+    bool erase(handle to_erase) {
+        if (!contains(to_erase)) {
+            return false;
+        }
+        Slot& erased_slot = slot(to_erase.index);
+        erased_slot.generation.store(to_erase.generation + 1, std::memory_order_release);
+        _size--;
+        erased_slot.value()->~ValueType();
+        _free_indices.push_back(to_erase.index);
+        return true;
+    }
+
+    inline bool contains(handle to_check) const {
+        return find_slot(to_check) != nullptr;
+    }
+
+    /// Returns a pointer to the value the handle points to, or nullptr if the handle is stale.
+    inline ValueType* get(handle to_get) {
+        auto found = find_slot(to_get);
+        return found != nullptr ? found->value() : nullptr;
+    }
+    inline const ValueType* get(handle to_get) const {
+        auto found = find_slot(to_get);
+        return found != nullptr ? found->value() : nullptr;
+    }
+
+    /// Returns the handles of every value currently in the map, in slot order.
+    std::vector<handle> handles() const {
+        std::vector<handle> output;
+        output.reserve(_size);
+        for (std::uint32_t index = next_alive(0); index < _slot_count; index = next_alive(index + 1)) {
+            output.push_back(handle{index, slot(index).generation.load(std::memory_order_relaxed)});
+        }
+        return output;
+    }
+
+    /// Allocates pages up front so that at least 'new_capacity' values can be held without further allocations.
+    void reserve(std::size_t new_capacity) {
+        while (capacity() < new_capacity) {
+            add_page();
+        }
+    }
+
+    void clear() {
+        for (std::uint32_t index = next_alive(0); index < _slot_count; index = next_alive(index + 1)) {
+            erase(handle{index, slot(index).generation.load(std::memory_order_relaxed)});
+        }
+    }
+
+    void swap(SlotMap& other) {
+        _pages.swap(other._pages);
+        _page_tables.swap(other._page_tables);
+        auto page_table = _page_table.load();
+        _page_table.store(other._page_table.load());
+        other._page_table.store(page_table);
+        _free_indices.swap(other._free_indices);
+        std::swap(_slot_count, other._slot_count);
+        std::swap(_size, other._size);
+    }
+
+    inline std::size_t size() const { return _size; }
+    inline bool empty() const { return _size == 0; }
+    inline std::size_t capacity() const { return _pages.size() * PageSize; }
+
+    iterator begin() { return iterator(this, next_alive(0)); }
+    iterator end() { return iterator(this, static_cast<std::uint32_t>(_slot_count)); }
+    const_iterator begin() const { return const_iterator(this, next_alive(0)); }
+    const_iterator end() const { return const_iterator(this, static_cast<std::uint32_t>(_slot_count)); }
+
+private:
+    inline Slot& slot(std::uint32_t index) { return _pages[index / PageSize][index % PageSize]; }
+    inline const Slot& slot(std::uint32_t index) const { return _pages[index / PageSize][index % PageSize]; }
+
+    const Slot* find_slot(handle to_find) const {
+        if ((to_find.generation & 1) == 0) {
+            return nullptr;
+        }
+        auto page_table = _page_table.load(std::memory_order_acquire);
+        if (page_table == nullptr || to_find.index / PageSize >= page_table->capacity) {
+            return nullptr;
+        }
+        auto page = page_table->pages[to_find.index / PageSize].load(std::memory_order_acquire);
+        if (page == nullptr || page[to_find.index % PageSize].generation.load(std::memory_order_acquire) != to_find.generation) {
+            return nullptr;
+        }
+        return &page[to_find.index % PageSize];
+    }
+    inline Slot* find_slot(handle to_find)
+        { return const_cast<Slot*>(static_cast<const SlotMap*>(this)->find_slot(to_find)); }
+
+    void add_page() {
+        _pages.emplace_back(new Slot[PageSize]);
+        auto page_table = _page_table.load(std::memory_order_relaxed);
+        if (page_table == nullptr || _pages.size() > page_table->capacity) {
+            std::unique_ptr<PageTable> grown(new PageTable(page_table == nullptr ? 16 : page_table->capacity * 2));
+            for (std::size_t index = 0; index + 1 < _pages.size(); index++) {
+                grown->pages[index].store(_pages[index].get(), std::memory_order_relaxed);
+            }
+            page_table = grown.get();
+            _page_tables.push_back(std::move(grown));
+            _page_table.store(page_table, std::memory_order_release);
+        }
+        page_table->pages[_pages.size() - 1].store(_pages.back().get(), std::memory_order_release);
+    }
+
+    std::uint32_t next_alive(std::uint32_t index) const {
+        while (index < _slot_count && !slot(index).alive()) {
+            index++;
+        }
+        return index < _slot_count ? index : static_cast<std::uint32_t>(_slot_count);
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> _pages;
+    std::vector<std::unique_ptr<PageTable>> _page_tables;
+    std::atomic<PageTable*> _page_table{ nullptr };
+    std::vector<std::uint32_t> _free_indices;
+    std::size_t _slot_count = 0;
+    std::size_t _size = 0;
+};
+
+
+/// SlotSet is a dense set of SlotHandles. Membership tests, insertion and removal are O(1), and the handles are kept in a
+/// contiguous array for linear iteration (removal swaps the last handle into the removed position).
+/// Only one handle per slot index may be present at a time: inserting a handle of a newer generation replaces the stale one.
+class SlotSet {
+public:
+    inline bool contains(SlotHandle to_check) const {
+        return to_check.index < _positions.size() && _positions[to_check.index] != npos &&
+            _handles[_positions[to_check.index]] == to_check;
+    }
+
+    /// Inserts the handle. Returns false if it was already present.
+    bool insert(SlotHandle to_insert) {
+        if (to_insert.index >= _positions.size()) {
+            _positions.resize(to_insert.index + 1, std::uint32_t(npos));
+        }
+        auto& position = _positions[to_insert.index];
+        if (position != npos) {
+            if (_handles[position] == to_insert) {
+                return false;
+            }
+            _handles[position] = to_insert;
+            return true;
+        }
+        position = static_cast<std::uint32_t>(_handles.size());
+        _handles.push_back(to_insert);
+        return true;
+    }
+
+    /// Removes the handle. Returns false if it wasn't present.
+    bool erase(SlotHandle to_erase) {
+        if (!contains(to_erase)) {
+            return false;
+        }
+        erase_at(_positions[to_erase.index]);
+        return true;
+    }
+
+    /// Removes the handle at 'position', moving the last handle of the set into its place.
+    void erase_at(std::size_t position) {
+        _positions[_handles[position].index] = npos;
+        if (position + 1 != _handles.size()) {
+            _handles[position] = _handles.back();
+            _positions[_handles[position].index] = static_cast<std::uint32_t>(position);
+        }
+        _handles.pop_back();
+    }
+
+    void clear() {
+        _positions.clear();
+        _handles.clear();
+    }
+
+    inline std::size_t size() const { return _handles.size(); }
+    inline bool empty() const { return _handles.empty(); }
+    inline const SlotHandle& operator[](std::size_t position) const { return _handles[position]; }
+    inline std::vector<SlotHandle>::const_iterator begin() const { return _handles.begin(); }
+    inline std::vector<SlotHandle>::const_iterator end() const { return _handles.end(); }
+
+private:
+    static constexpr std::uint32_t npos = static_cast<std::uint32_t>(-1);
+    std::vector<std::uint32_t> _positions;
+    std::vector<SlotHandle> _handles;
+};
+
+}
+#endif
@@ -0,0 +1,146 @@
+#ifndef Ember_Snapshot_hpp
+#define Ember_Snapshot_hpp
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+
+#include "ember/core/SlotMap.hpp"
+#include "ember/core/BehaviourType.hpp"
+
+namespace ember {
+
+/// Snapshots of a scene (see Scene::writeSnapshot) are written into a single contiguous byte buffer, as a header followed by frames.
+/// Header (8 bytes): 'E' 'S', format version, SnapshotMode, frame count (u32).
+/// Frame (15 bytes + payload): object slot index (u32), object generation (u32), snapshot tag of the behaviour's type (u16, see SnapshotTags),
+/// SnapshotFrameKind (u8), payload size (u32), then the payload written by the behaviour. Integers in the header and frames are little endian;
+/// payloads are whatever the behaviours wrote. Deltas report removed objects as Tombstones, without tag nor payload, so replicas fed only deltas
+/// drop them too. Behaviours are never removed from an object that remains in the scene, so there's no frame for that.
+enum class SnapshotMode : std::uint8_t {
+    /// Every object, with every behaviour serializable into a SnapshotWriter
+    Full = 0,
+    /// Only the behaviours changed since the previous delta, and the objects removed since then
+    Delta = 1
+};
+
+enum class SnapshotFrameKind : std::uint8_t {
+    /// The payload holds the behaviour's full serialization (SerializableInto::SerializeInto)
+    Full = 0,
+    /// The payload holds the behaviour's changes since its previous partial serialization (SerializableInto::PartialSerializeInto)
+    Partial = 1,
+    /// The object was removed from the scene. No type id nor payload
+    Tombstone = 2
+};
+
+/// Snapshot tags identify the type of the behaviour serialized in each frame. Unlike behaviour type ids (see BehaviourType.hpp), which depend
+/// on the order types are first used in, tags are chosen by the user, so they mean the same across processes and builds. Every behaviour type
+/// serializable into snapshots must be given a tag before a snapshot holding one of its behaviours is written.
+/// Tags should be registered at startup: registering isn't safe while snapshots are written, or tags looked up, from other threads.
+class SnapshotTags {
+public:
+    /// Gives BehaviourSubType the tag 'tag'. Registering the same tag for the same type again has no effect.
+    /// Throws std::invalid_argument if the type already has another tag, or the tag was given to another type.
+    template <typename BehaviourSubType>
+    static void Register(std::uint16_t tag) { Register(BehaviourType::Id<BehaviourSubType>(), tag); }
+
+    /// Tag of BehaviourSubType. Throws std::invalid_argument if it has none.
+    template <typename BehaviourSubType>
+    static std::uint16_t Of() { return Of(BehaviourType::Id<BehaviourSubType>()); }
+
+    static void Register(BehaviourTypeId type_id, std::uint16_t tag);
+    static std::uint16_t Of(BehaviourTypeId type_id);
+};
+
+/// The type behaviours serialize into to take part in snapshots, by deriving from addons::SerializableInto<SnapshotWriter>, once their type
+/// has a snapshot tag.
+/// Writes straight into the snapshot's buffer, behind the header of the behaviour's frame.
+class SnapshotWriter {
+    friend class Scene;
+public:
+    static constexpr std::size_t header_size = 8;
+    static constexpr std::size_t frame_header_size = 15;
+
+    void write(const void* data, std::size_t size);
+
+    /// Writes the bytes of a trivially copyable value.
+    template <typename ValueType>
+    inline void write(const ValueType& value) {
+        static_assert(std::is_trivially_copyable<ValueType>::value, "SnapshotWriter - Only trivially copyable values can be written as bytes");
+        write(&value, sizeof(ValueType));
+    }
+
+    /// Bytes written so far into the current frame's payload.
+    inline std::size_t payload_size() const { return _buffer.size() - _frame_begin - frame_header_size; }
+
+private:
+    explicit SnapshotWriter(std::vector<std::uint8_t>& buffer) : _buffer(buffer) {}
+
+    // Clears the buffer, keeping its capacity, and writes the header
+    void BeginSnapshot(SnapshotMode mode);
+    // Reserves the header of a frame, its payload following
+    void BeginFrame();
+    // Drops the payload written since BeginFrame
+    void RewindFrame();
+    void EndFrame(SlotHandle object_id, std::uint16_t tag, SnapshotFrameKind kind);
+    // Writes the frame count into the header
+    void EndSnapshot();
+    // Appends the frames written by 'other', a writer of another buffer
+    void AppendFrames(const SnapshotWriter& other);
+
+    std::vector<std::uint8_t>& _buffer;
+    std::size_t _frame_begin = 0;
+    std::uint32_t _frame_count = 0;
+};
+
+/// A frame read from a snapshot. The payload points into the snapshot's buffer.
+struct SnapshotFrame {
+    SlotHandle object_id;
+    /// Snapshot tag of the behaviour's type (see SnapshotTags), 0 for tombstones
+    std::uint16_t tag = 0;
+    SnapshotFrameKind kind = SnapshotFrameKind::Full;
+    const std::uint8_t* payload = nullptr;
+    std::size_t payload_size = 0;
+
+    /// Reads a trivially copyable value at 'offset' within the payload, and moves the offset past it.
+    /// Throws std::out_of_range if the payload is too short.
+    template <typename ValueType>
+    ValueType read(std::size_t& offset) const {
+        static_assert(std::is_trivially_copyable<ValueType>::value, "SnapshotFrame - Only trivially copyable values can be read as bytes");
+        if (offset + sizeof(ValueType) > payload_size) {
+            throw std::out_of_range("SnapshotFrame::read - Reading past the end of the payload");
+        }
+        ValueType value;
+        std::memcpy(&value, payload + offset, sizeof(ValueType));
+        offset += sizeof(ValueType);
+        return value;
+    }
+};
+
+/// Walks the frames of a snapshot, in the order they were written, without copying it. The buffer must outlive the reader.
+class SnapshotReader {
+public:
+    /// Throws std::invalid_argument if the buffer doesn't start with a snapshot header.
+    SnapshotReader(const std::uint8_t* data, std::size_t size);
+    explicit SnapshotReader(const std::vector<std::uint8_t>& buffer) : SnapshotReader(buffer.data(), buffer.size()) {}
+
+    inline SnapshotMode mode() const { return _mode; }
+    inline std::size_t frame_count() const { return _frame_count; }
+
+    /// Reads the next frame into 'frame', returning false once every frame was read.
+    /// Throws std::invalid_argument if the buffer ends in the middle of a frame, or the frame is of an unknown kind.
+    bool next(SnapshotFrame& frame);
+
+private:
+    const std::uint8_t* _data;
+    std::size_t _size;
+    std::size_t _position = SnapshotWriter::header_size;
+    SnapshotMode _mode = SnapshotMode::Full;
+    std::size_t _frame_count = 0;
+    std::size_t _frames_read = 0;
+};
+
+}
+#endif
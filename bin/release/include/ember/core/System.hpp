@@ -0,0 +1,267 @@
+#ifndef Ember_BaseSystem_hpp
+#define Ember_BaseSystem_hpp
+
+#include <map>
+#include <vector>
+#include <memory>
+#include <stdexcept>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+#include "ember/core/SlotMap.hpp"
+#include "ember/core/Archetype.hpp"
+#include "ember/core/GameObject.hpp"
+#include "ember/core/Query.hpp"
+#include "ember/sys/SystemFilters.hpp"
+#include "ember/sys/SystemAccess.hpp"
+
+namespace ember {
+
+/// The BaseSystem is the Foundation for a System in Ember. It's not the class you should subclass (you can, but your life will be easier
+/// if you subclass via the 'System' class, defined below).
+/// BaseSystem however defines the API every system must use, providing a few different approaches of varying complexity when writting custom systems.
+class BaseSystem {
+    friend class Scene;
+    template <typename... BehaviourTypes> friend class TypedSystem;
+public:
+    using SystemFilter = std::function<bool(const GameObject& object)>;
+
+    /// Systems built from a filter function alone are tested through it whenever any behaviour is added to an object.
+    BaseSystem(SystemFilter filter, sys::SystemAccess access = sys::SystemAccess()) :
+        BaseSystem(std::move(filter), InexactFilterMasks(), std::move(access)) {}
+    /// Objects must pass both the filter masks and, if the masks are not exact, the filter function (see FilterMasks in SystemFilters.hpp).
+    BaseSystem(SystemFilter filter, sys::FilterMasks filter_masks, sys::SystemAccess access = sys::SystemAccess()) :
+        _filter_fun(std::move(filter)), _filter_masks(std::move(filter_masks)), _access(std::move(access)) {}
+    BaseSystem(const BaseSystem& other) = delete;
+    BaseSystem& operator=(const BaseSystem& other) = delete;
+
+public:
+    inline ember::Scene& scene() { return *_parent_scene; }
+    inline const ember::Scene& scene() const { return *_parent_scene; }
+
+    /// The Behaviour types this system declared it reads and writes during its update phases (see SystemAccess.hpp).
+    inline const sys::SystemAccess& access() const { return _access; }
+
+    /// Opts the system into processing its objects in parallel, in the default onPreUpdate/onUpdate/onPostUpdate implementations.
+    /// The managed objects are split in chunks of 'grain_size' objects, processed across the scene worker threads (see Scene::setWorkerCount),
+    /// so the per object callbacks may run concurrently, and must only touch the object they receive.
+    /// A grain size of 0 (the default) keeps the iteration serial. Iteration is also serial if the scene has no workers, or the system has
+    /// no more than 'grain_size' objects.
+    inline void setParallelGrainSize(std::size_t grain_size) { _parallel_grain_size = grain_size; }
+    inline std::size_t parallelGrainSize() const { return _parallel_grain_size; }
+
+    /// Limits how often the system runs, in updates per second (of the deltaT given to the Scene, in milliseconds). On update cycles where the
+    /// system doesn't run none of its update callbacks are called; when it does run, onUpdate receives the time elapsed since it last ran.
+    /// The scene spreads systems with a limited rate across different update cycles, so they don't all run on the same one.
+    /// A rate of 0 (the default) runs the system on every update cycle.
+    void setTickRate(double ticks_per_second);
+    inline double tickRate() const { return _tick_period > 0 ? 1000.0 / _tick_period : 0; }
+
+protected:
+    // Will be called by Scene, Should be Overriden on subclasses.
+
+    /// Will be called when the Scene starts. Should be used for any initial setup on the system that depends on having a Scene connection.
+    virtual void onStart() {}
+    /// Will be called when the Scene will be destroyed. Should be used for any necessary resource deallocation that depends on having a scene connection.
+    virtual void onEnd() {}
+
+    // --- Basic System Usage
+    // Override these methods if your system simply has to do a specific job on each of it's filtered gameobjects. If you don't need to correlate multiple objects in the system, and if all
+    // your action are on an object by object basis, use these overrides.
+
+    /// Will be called at the start of the Scene Update Cycle. Should be used to prepare the objects in the system for the incoming update (clearing 'per cycle' flags for example).
+    virtual void onPreUpdate(GameObject& /*object*/) {}
+
+    /// The central function of the update cycle, should be responsible for enacting whatever actions the system exists for. Receives, in milliseconds, how much time has passed since the last update cycle.
+    virtual void onUpdate(double /*deltaT*/, GameObject& /*object*/) {}
+
+    /// Will be called at the end of the Scene Update Cycle. Should be used to deal with the outcomes of the update, or to cleanup after any loose ends after the update call.
+    virtual void onPostUpdate(GameObject& /*object*/) {}
+
+
+    // --- Advanced System Usage
+    // Override these if you want to directly affect the entire flow of the system (potentially not iterating over all filtered objects, taking action on the set of object as a whole, etc...)
+    // Override these if the actions of this system are not necessarily on each of it's objects individually.
+    // Keep in mind that if you don't call the base system implementations the _managed_objects container won't be automatically cleaned of ids of no longer existing objects. Either call the base methods, or enact the
+    // cleanup yourself, as your logic allows.
+
+    /// Will be called at the start of the Scene Update Cycle. Should be used to prepare the objects in the system for the incoming update (clearing 'per cycle' flags for example).
+    virtual void onPreUpdate();
+
+    /// The central function of the update cycle, should be responsible for enacting whatever actions the system exists for. Receives, in milliseconds, how much time has passed since the last update cycle.
+    virtual void onUpdate(double deltaT);
+
+    /// Will be called at the end of the Scene Update Cycle. Should be used to deal with the outcomes of the update, or to cleanup after any loose ends after the update call.
+    virtual void onPostUpdate();
+
+    // --- Advanced Insertion and Deletion of GameObjects
+    /// If your system has special requirements for storing GameObjects (you want to use a container other than _managed_objects bellow) override these methods.
+
+    /// onGameObjectAdded will be called every time an object is successfully filtered into the system, either as it is added, or as it's contained behaviours change.
+    /// Keep in mind that if you're not using _managed_objects then this can be called more than once for the same object (if, after being filtered into the system, the object changes, but is still system valid).
+    virtual void onGameObjectAdded(GameObject& object);
+
+    /// onGameObjectRemoved will be called every time an object fails to pass the filter into the system. Either on the first time it's attempted to be filtered, or if the object changes behaviours and is no longer system valid.
+    virtual void onGameObjectRemoved(GameObject& object);
+
+    // --- Streaming through Behaviours
+
+    /// Calls 'fun(BehaviourTypes&...)' with the behaviours of every awake object in the system. Every type must be required by the system's filter,
+    /// as with RequiresBehaviours, or std::invalid_argument is thrown.
+    /// With archetype storage enabled (see Scene::setArchetypeStorage) and an exact filter (see FilterMasks), the archetypes matching the filter are
+    /// streamed chunk by chunk, reading each type's column linearly, instead of looking the behaviours up object by object. Chunks are walked
+    /// serially. Otherwise the managed objects are walked, as by the default onUpdate. Must not be called from the callbacks of another traversal.
+    template <typename... BehaviourTypes, typename Function>
+    void streamBehaviours(Function&& fun) {
+        BehaviourMask types;
+        int expand[] = { 0, (types.set(BehaviourType::Id<BehaviourTypes>()), 0)... };
+        (void)expand;
+        if (!_filter_masks.required.contains(types)) {
+            throw std::invalid_argument("BaseSystem::streamBehaviours - Every behaviour type must be required by the system's filter");
+        }
+        std::vector<const Archetype*> archetypes;
+        if (!MatchingArchetypes(archetypes)) {
+            ForEachManagedObject([&fun](GameObject& object) { fun(object.refBehaviour<BehaviourTypes>()...); });
+            return;
+        }
+        for (auto archetype : archetypes) {
+            std::size_t columns[] = { archetype->ColumnOf(BehaviourType::Id<BehaviourTypes>())... };
+            for (const auto& chunk : archetype->chunks()) {
+                StreamChunk<BehaviourTypes...>(*chunk, columns, fun, std::index_sequence_for<BehaviourTypes...>());
+            }
+        }
+    }
+
+
+protected:
+    /// Ids of the objects filtered into the system. Ids of objects destroyed since they were added are only removed when the set is next traversed,
+    /// so entries should be resolved through Scene::hasGameObject/refGameObject before use.
+    SlotSet _managed_objects;
+
+    /// Internal
+    #include "_priv/System_priv.hpp"
+};
+
+
+template <typename... BehaviourTypes, typename Function, std::size_t... Indices>
+void BaseSystem::StreamChunk(const Archetype::Chunk& chunk, const std::size_t* columns, Function& fun, std::index_sequence<Indices...>) {
+    Behaviour* const* column_data[] = { chunk.column(columns[Indices])... };
+    for (std::size_t row = 0; row < chunk.size; row++) {
+        if (!chunk.asleep[row]) {
+            fun(*static_cast<BehaviourTypes*>(column_data[Indices][row])...);
+        }
+    }
+}
+
+
+/// The System is a subclass of base system that receives a filter through a Template parameter. It's most useful in conjunction with the Filters defined in SystemFilters.hpp to easily define the restrictions of
+/// your custom system right on their inheritance declaration. In all other things, System behaves just like the base system.
+/// Optionally, the filter can be followed by Reads<...> and Writes<...> declarations (SystemAccess.hpp), stating which Behaviour types the system accesses,
+/// allowing the Scene to run it at the same time as other non conflicting systems, when the scene has worker threads.
+template <typename Filter, typename... AccessDeclarations>
+class System : public BaseSystem {
+    friend class Scene;
+public:
+    System() : BaseSystem(Filter::GetFilterFun(), LoweredFilter(), DeclaredAccess()) {}
+
+private:
+    static sys::FilterMasks LoweredFilter() {
+        sys::FilterMasks masks;
+        sys::AppendFilterMasks<Filter>(masks, 0);
+        return masks;
+    }
+
+    static sys::SystemAccess DeclaredAccess() {
+        sys::SystemAccess access;
+        access.declared = sizeof...(AccessDeclarations) != 0;
+        int expand[] = { 0, (AccessDeclarations::AppendTo(access), 0)... };
+        (void)expand;
+        return access;
+    }
+};
+
+
+/// The TypedSystem is a System for objects holding a behaviour of each of the listed types, whose per object callbacks receive references to
+/// those behaviours, instead of the GameObject: 'class Mover : public TypedSystem<const Velocity, Position>' overrides
+/// 'onUpdate(double deltaT, const Velocity& velocity, Position& position)'.
+/// The behaviours are resolved once, as objects enter the system, into rows kept by the scene (the same rows backing Scene::query), so its update
+/// phases are a linear walk over behaviour pointers, with no lookups. The rows are set up when the system is attached. Only awake objects are visited.
+/// The system's access is declared from its types: types listed as const are read, all others written. The default onPreUpdate/onUpdate/onPostUpdate
+/// implementations honour setParallelGrainSize, like the ones of BaseSystem. '_managed_objects' is not used.
+template <typename... BehaviourTypes>
+class TypedSystem : public BaseSystem {
+    static_assert(sizeof...(BehaviourTypes) != 0, "TypedSystem - At least one behaviour type must be provided");
+    using Filter = sys::RequiresBehaviours<typename std::remove_const<BehaviourTypes>::type...>;
+public:
+    TypedSystem() : BaseSystem(Filter::GetFilterFun(), LoweredFilter(), DeclaredAccess()) {}
+
+protected:
+    /// Will be called at the start of the Scene Update Cycle, for every object in the system.
+    virtual void onPreUpdate(BehaviourTypes&... /*behaviours*/) {}
+
+    /// Will be called on the Scene Update Cycle for every object in the system. Receives, in milliseconds, how much time has passed since the last update cycle.
+    virtual void onUpdate(double /*deltaT*/, BehaviourTypes&... /*behaviours*/) {}
+
+    /// Will be called at the end of the Scene Update Cycle, for every object in the system.
+    virtual void onPostUpdate(BehaviourTypes&... /*behaviours*/) {}
+
+    void onPreUpdate() override {
+        ForEachRow([this](BehaviourTypes&... behaviours) { onPreUpdate(behaviours...); });
+    }
+
+    void onUpdate(double deltaT) override {
+        ForEachRow([this, deltaT](BehaviourTypes&... behaviours) { onUpdate(deltaT, behaviours...); });
+    }
+
+    void onPostUpdate() override {
+        ForEachRow([this](BehaviourTypes&... behaviours) { onPostUpdate(behaviours...); });
+    }
+
+    // Membership is kept by the scene's rows
+    void onGameObjectAdded(GameObject& /*object*/) override {}
+    void onGameObjectRemoved(GameObject& /*object*/) override {}
+
+private:
+    void BindToScene() override {
+        _index = &SceneQueryIndex(_filter_masks.required);
+        std::size_t type = 0;
+        int expand[] = { 0, (_columns[type++] = _filter_masks.required.rank(BehaviourType::Id<BehaviourTypes>()), 0)... };
+        (void)expand;
+    }
+
+    template <typename Function>
+    void ForEachRow(Function&& fun) {
+        ForEachRowRange(_index->size(), [this, &fun](std::size_t row_begin, std::size_t row_end) {
+            for (std::size_t row = row_begin; row < row_end; row++) {
+                CallWithRow(fun, row, std::index_sequence_for<BehaviourTypes...>());
+            }
+        });
+    }
+
+    template <typename Function, std::size_t... Indices>
+    inline void CallWithRow(Function& fun, std::size_t row, std::index_sequence<Indices...>) const {
+        fun(static_cast<BehaviourTypes&>(*_index->behaviour(row, _columns[Indices]))...);
+    }
+
+    static sys::FilterMasks LoweredFilter() {
+        sys::FilterMasks masks;
+        sys::AppendFilterMasks<Filter>(masks, 0);
+        return masks;
+    }
+
+    static sys::SystemAccess DeclaredAccess() {
+        sys::SystemAccess access;
+        access.declared = true;
+        int expand[] = { 0, ((std::is_const<BehaviourTypes>::value ? access.reads : access.writes).push_back(
+            std::type_index(typeid(BehaviourTypes))), 0)... };
+        (void)expand;
+        return access;
+    }
+
+    const QueryIndex* _index = nullptr;
+    std::size_t _columns[sizeof...(BehaviourTypes)] = {};
+};
+
+}
+#endif
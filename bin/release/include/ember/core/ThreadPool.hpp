@@ -0,0 +1,48 @@
+#ifndef Ember_ThreadPool_hpp
+#define Ember_ThreadPool_hpp
+
+#include <cstddef>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+namespace ember {
+
+/// The ThreadPool is a work-stealing pool of worker threads, used by the Scene to run Systems (and their objects) in parallel.
+/// Each worker owns a queue of jobs, taking from the back of its own queue, and stealing from the front of the other workers' queues when
+/// it runs out of work.
+/// A pool with no workers runs every job inline, on the calling thread.
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(std::size_t worker_count);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool& other) = delete;
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+
+public:
+    inline std::size_t worker_count() const { return _workers.size(); }
+
+    /// Runs every task across the pool, returning once all of them have completed.
+    /// The calling thread executes queued jobs while it waits, so Run may safely be called from inside a running task.
+    /// If any task throws, the first exception caught is rethrown from Run, after all other tasks have completed.
+    void Run(std::vector<Task> tasks);
+
+    /// Splits [begin, end) in consecutive chunks of at most 'grain_size' indices, and calls 'fun(chunk_begin, chunk_end)' once per chunk,
+    /// across the pool. Returns once every chunk has been processed.
+    void ParallelFor(std::size_t begin, std::size_t end, std::size_t grain_size,
+        const std::function<void(std::size_t, std::size_t)>& fun);
+
+    // Private members of ThreadPool contained in header
+    #include "_priv/ThreadPool_priv.hpp"
+};
+
+}
+#endif
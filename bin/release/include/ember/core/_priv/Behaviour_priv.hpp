@@ -0,0 +1,29 @@
+
+// Class private methods
+private:
+	inline void setGameObjectOwner(GameObject* gameObjectOwner) { _gameObjectOwner = gameObjectOwner; }
+
+// Class Variables
+private:
+    static constexpr std::size_t hook_phase_count = 3;
+    BehaviourTypeId _type_id = 0;
+    // Bitmask of the update cycle hooks overridden by the behaviour's type (see BehaviourHooks.hpp), all of them if unknown
+    unsigned _overridden_hooks = ~0u;
+    // Set while the behaviour is in its scene's dispatch lists, with its position in the list of each phase it overrides
+    bool _hooks_registered = false;
+    std::size_t _dispatch_positions[hook_phase_count] = {};
+    // Set while the behaviour is in its scene's list of behaviours of its type, with its position in it
+    bool _indexed_by_type = false;
+    std::size_t _type_list_position = 0;
+
+    // Changes to report in the scene's next delta snapshot: serialization changed, or never sent (see Scene::writeSnapshot)
+    static constexpr unsigned char snapshot_changed = 1u << 0;
+    static constexpr unsigned char snapshot_unsent = 1u << 1;
+    std::atomic<unsigned char> _snapshot_state{ 0 };
+    // Declared by the behaviour (see setReportsSerializationChanges). Its serialization caches are then trusted until it reports a change,
+    // instead of asking it through IsSerializationDirty as each cycle ends
+    bool _reports_serialization_changes = false;
+
+    Behaviour::id _id = Behaviour::id{SlotHandle{}, 0};
+    // Weak pointer to owning GameObject instance
+	GameObject* _gameObjectOwner = nullptr;
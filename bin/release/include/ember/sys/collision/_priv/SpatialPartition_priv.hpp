@@ -0,0 +1,5 @@
+// File containing the private API and internal workings of SpaptialPartition to avoid polluting the public API file.
+
+// Class Variables
+private:
+    class CollisionEngine* _owning_engine;
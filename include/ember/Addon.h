@@ -1,3 +1,4 @@
 #include "addons/ListensTo.hpp"
 #include "addons/Serializable.hpp"
 #include "addons/DirtyValue.hpp"
+#include "addons/VersionedValue.hpp"
@@ -1,15 +1,36 @@
 #ifndef Ember_ListensTo_hpp
 #define Ember_ListensTo_hpp
 
+#include <cstddef>
+
 namespace ember {
 namespace addons {
 
+/// A contiguous, read only range of events, handed to listeners when queued events are delivered in bulk.
+template <typename EventType>
+struct EventSpan {
+    const EventType* data = nullptr;
+    std::size_t size = 0;
+
+    inline const EventType* begin() const { return data; }
+    inline const EventType* end() const { return data + size; }
+    inline const EventType& operator[](std::size_t index) const { return data[index]; }
+};
+
 /// Listens to is used to interface with the event system present in ember.
 /// By making your custom Behaviour class inherit from ListenTo, you can be ready to handle events of TypeToReceive.
 template <typename TypeToReceive>
 class ListensTo {
 public:
     virtual void Handle(const TypeToReceive& message) = 0;
+
+    /// Handles every event queued for the listener since the last flush (see Scene::QueueEvent), in the order they were queued.
+    /// Calls Handle on each of them by default; override it to process them in bulk.
+    virtual void HandleBatch(const EventSpan<TypeToReceive>& messages) {
+        for (const auto& message : messages) {
+            Handle(message);
+        }
+    }
 };
 
 }}
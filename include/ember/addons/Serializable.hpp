@@ -25,6 +25,9 @@ public:
     /// Should be overwritten for greater performance, will inform the gameobject if the object is dirty for serializations of this type.
     /// It can prevent useless calls to PartialSerializeInto, if nothing changed.
     /// The currently cached serialization object is passed into the function in case it's helpfull to determine if anything has changed.
+    /// It's called in the post update step of each update cycle, while the object holds a cached serialization of this type.
+    /// Not called on behaviours that declared they report every change through Behaviour::MarkSerializationDirty, the cheaper alternative
+    /// (see Behaviour::setReportsSerializationChanges).
     virtual bool IsSerializationDirty(const std::shared_ptr<TypeToSerializeTo>& /*currently_cached*/ = nullptr) { return true; }
 };
 
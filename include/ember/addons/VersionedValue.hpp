@@ -0,0 +1,35 @@
+#ifndef Ember_VersionedValue_hpp
+#define Ember_VersionedValue_hpp
+
+#include <utility>
+#include <cstdint>
+
+#include "ember/core/Behaviour.hpp"
+#include "ember/core/ChangeJournal.hpp"
+
+namespace ember {
+namespace addons {
+
+/// Versioned Value is the variant of DirtyValue for values read by several independent consumers (networking, persistence, a UI mirror...).
+/// Instead of a single dirty flag, that only one consumer may clean, every set() gives the value a new version (see JournalEntry), so each
+/// consumer remembers the version it last saw, and asks whether the value changed since, in constant time, without affecting the others.
+/// Changes are also recorded in the journal of the owning behaviour's scene, through which a consumer visits exactly the values changed since
+/// its last pass (see Scene::forEachChangeSince), and reported to the owning behaviour (see Behaviour::MarkSerializationDirty).
+template <typename ParamType>
+class VersionedValue : public JournalEntry {
+public:
+    VersionedValue(Behaviour& owner, ParamType data) : JournalEntry(owner), _data(std::move(data)) {}
+
+    const ParamType& get() const { return _data; }
+    void set(ParamType new_data) {
+        std::swap(_data, new_data);
+        RecordChange();
+        owner().MarkSerializationDirty();
+    }
+
+private:
+    ParamType _data;
+};
+
+}}
+#endif
@@ -1,14 +1,19 @@
 #ifndef Ember_Behaviour_hpp
 #define Ember_Behaviour_hpp
 
+#include <atomic>
 #include <memory>
 #include <cstddef>
 #include <stdexcept>
 
+#include "ember/core/SlotMap.hpp"
+#include "ember/core/BehaviourType.hpp"
+
 namespace ember {
 
 class GameObject;
 class Scene;
+struct BehaviourHooks;
 
 /// The Behaviour is the heart of ember, and alongside the Systems, the main customizable part of the Framework.
 /// In Using Ember, you are expected to write your own Behaviours (subclasses of this class), to achieve any and every goal you have
@@ -18,9 +23,12 @@ class Scene;
 /// such as event listening, and Serialization.
 class Behaviour {
 	friend GameObject;
+	friend Scene;
+	friend BehaviourHooks;
 public:
     /// Type that defined the id of a Behaviour. Identifies a behaviour as unique inside a scene.
-    using id = std::pair<std::size_t, std::size_t>;
+    /// Formed by the id of the owning GameObject, and the index of the behaviour within it.
+    using id = std::pair<SlotHandle, std::size_t>;
 
 protected:
     // When creating the subclass constructor, keep in mind that it should only be concerned with initializing Behaviour internals.
@@ -60,6 +68,21 @@ public:
 	inline GameObject& game_object() { return *_gameObjectOwner; };
     inline const GameObject& game_object() const { return *_gameObjectOwner; };
 
+    /// Flags the state the behaviour serializes as changed: the serializations its object cached are dropped from the next update cycle on
+    /// (see GameObject::SerializeInto), and the next delta snapshot of its scene includes the behaviour (see Scene::writeSnapshot).
+    /// Called by DirtyValues and VersionedValues bound to the behaviour whenever they're set. Safe to call from any thread.
+    void MarkSerializationDirty();
+
+    /// True if the behaviour declared that it reports every change to its serialization (see setReportsSerializationChanges).
+    inline bool reportsSerializationChanges() const { return _reports_serialization_changes; }
+
+protected:
+    /// Declares that every change to the state the behaviour serializes is reported through MarkSerializationDirty, directly or through bound
+    /// DirtyValues and VersionedValues. The serializations its object caches are then trusted until it reports a change, and IsSerializationDirty
+    /// is no longer called on it. Behaviours that don't declare it are still asked through IsSerializationDirty as each update cycle ends, even if
+    /// they also report changes, so state kept outside of bound values is never missed. Should be called from the behaviour's constructor.
+    inline void setReportsSerializationChanges(bool reports = true) { _reports_serialization_changes = reports; }
+
     // Private
     #include "_priv/Behaviour_priv.hpp"
 };
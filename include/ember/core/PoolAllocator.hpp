@@ -0,0 +1,120 @@
+#ifndef Ember_PoolAllocator_hpp
+#define Ember_PoolAllocator_hpp
+
+#include <cstddef>
+#include <mutex>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace ember {
+
+/// BlockPool hands out fixed size memory blocks, carved from slabs allocated on demand. Freed blocks go back to a free list and are reused,
+/// so once a pool has grown to the peak number of live blocks, allocating and freeing does no heap traffic at all.
+/// Slabs are only returned to the heap when the pool is destroyed. Thread safe.
+class BlockPool {
+public:
+    static constexpr std::size_t block_alignment = alignof(std::max_align_t);
+
+    explicit BlockPool(std::size_t block_size, std::size_t blocks_per_slab = 256);
+    ~BlockPool();
+    BlockPool(const BlockPool& other) = delete;
+    BlockPool& operator=(const BlockPool& other) = delete;
+
+public:
+    void* allocate();
+    void deallocate(void* block) noexcept;
+
+    /// Grows the pool until it holds at least 'count' blocks in total (live and free).
+    void reserve(std::size_t count);
+
+    inline std::size_t block_size() const { return _block_size; }
+    /// Total number of blocks held by the pool, live and free.
+    std::size_t capacity() const;
+    /// Number of blocks currently handed out.
+    std::size_t size() const;
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    // Must be called with the mutex held
+    void AddSlab(std::size_t block_count);
+
+    const std::size_t _block_size;
+    const std::size_t _blocks_per_slab;
+    mutable std::mutex _mutex;
+    std::vector<void*> _slabs;
+    FreeBlock* _free_list = nullptr;
+    std::size_t _capacity = 0;
+    std::size_t _size = 0;
+};
+
+/// Returns the pool shared by every PoolAllocator tagged with 'Tag'. Each pool is created on first use and never destroyed, so objects allocated
+/// from it may safely outlive any scene (and static destructors).
+/// Blocks are sized for a 'Tag' plus the bookkeeping a container or shared_ptr keeps next to it (a map node, a shared_ptr control block).
+template <typename Tag>
+BlockPool& PoolFor() {
+    static constexpr std::size_t overhead = 4 * sizeof(void*);
+    static constexpr std::size_t alignment = BlockPool::block_alignment;
+    static BlockPool* pool = new BlockPool((sizeof(Tag) + overhead + alignment - 1) / alignment * alignment);
+    return *pool;
+}
+
+/// Returns the smallest of a set of shared pools with power of two block sizes (up to 4 KiB) that fits 'bytes', or nullptr if none does.
+/// Used for variable sized requests, such as the storage of small vectors.
+BlockPool* SizeClassPoolFor(std::size_t bytes);
+
+/// PoolAllocator is a standard allocator drawing single objects from the pool tagged with 'Tag' (see PoolFor). The tag survives rebinding, so
+/// std::allocate_shared<T>(PoolAllocator<T>()) allocates the object together with its control block from the pool of T.
+/// Requests for several objects (the storage of a vector) are drawn from the size class pools instead, and requests too big for those,
+/// or over-aligned types, fall back to the heap.
+template <typename ValueType, typename Tag = ValueType>
+class PoolAllocator {
+public:
+    using value_type = ValueType;
+    template <typename OtherType>
+    struct rebind { using other = PoolAllocator<OtherType, Tag>; };
+
+    PoolAllocator() noexcept = default;
+    template <typename OtherType>
+    PoolAllocator(const PoolAllocator<OtherType, Tag>&) noexcept {}
+
+    ValueType* allocate(std::size_t count) {
+        if (FitsInBlock(count)) {
+            return static_cast<ValueType*>(PoolFor<Tag>().allocate());
+        }
+        if (auto pool = SizeClassPool(count)) {
+            return static_cast<ValueType*>(pool->allocate());
+        }
+        return static_cast<ValueType*>(::operator new(count * sizeof(ValueType)));
+    }
+
+    void deallocate(ValueType* pointer, std::size_t count) noexcept {
+        if (FitsInBlock(count)) {
+            PoolFor<Tag>().deallocate(pointer);
+        } else if (auto pool = SizeClassPool(count)) {
+            pool->deallocate(pointer);
+        } else {
+            ::operator delete(pointer);
+        }
+    }
+
+private:
+    static bool FitsInBlock(std::size_t count) {
+        return count == 1 && sizeof(ValueType) <= PoolFor<Tag>().block_size() && alignof(ValueType) <= BlockPool::block_alignment;
+    }
+
+    static BlockPool* SizeClassPool(std::size_t count) {
+        return alignof(ValueType) <= BlockPool::block_alignment ? SizeClassPoolFor(count * sizeof(ValueType)) : nullptr;
+    }
+};
+
+template <typename ValueType, typename OtherType, typename Tag>
+inline bool operator==(const PoolAllocator<ValueType, Tag>&, const PoolAllocator<OtherType, Tag>&) { return true; }
+template <typename ValueType, typename OtherType, typename Tag>
+inline bool operator!=(const PoolAllocator<ValueType, Tag>&, const PoolAllocator<OtherType, Tag>&) { return false; }
+
+}
+#endif
@@ -0,0 +1,69 @@
+#ifndef Ember_SubtypeRegistry_hpp
+#define Ember_SubtypeRegistry_hpp
+
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <type_traits>
+
+#include "ember/core/BehaviourType.hpp"
+
+namespace ember {
+
+class Behaviour;
+
+/// A SubtypeRegistry records, for one base type, which behaviour types derive from it, and where the base lies within each of them.
+/// The base can be any class behaviours may derive from, including addons such as ListensTo or SerializableInto.
+/// Each behaviour type is resolved against a base once, through a dynamic_cast on the first instance examined for that base. From then on,
+/// finding the behaviours of an object deriving from the base is a mask intersection, and casting to the base is a pointer offset.
+/// Lookups are lock free and safe from any thread; resolving new types takes a lock.
+class SubtypeRegistry {
+public:
+    template <typename BaseType>
+    static SubtypeRegistry& For() {
+        // Never destroyed, so behaviours may be queried from static destructors
+        static SubtypeRegistry* registry = new SubtypeRegistry(&CastTo<typename std::remove_const<BaseType>::type>);
+        return *registry;
+    }
+
+    SubtypeRegistry(const SubtypeRegistry& other) = delete;
+    SubtypeRegistry& operator=(const SubtypeRegistry& other) = delete;
+
+public:
+    /// True if every type in 'types' was already resolved against the base.
+    bool IsResolved(const BehaviourMask& types) const;
+
+    /// Resolves the type with id 'type_id' against the base, through 'instance', a behaviour of that type.
+    void Resolve(BehaviourTypeId type_id, Behaviour* instance);
+
+    /// The types in 'types' deriving from the base. Only meaningful for resolved types.
+    BehaviourMask Derived(const BehaviourMask& types) const;
+    bool AnyDerived(const BehaviourMask& types) const;
+
+    /// Casts 'behaviour', of the resolved derived type with id 'type_id', to the base.
+    template <typename BaseType>
+    inline BaseType* Cast(Behaviour* behaviour, BehaviourTypeId type_id) const {
+        return reinterpret_cast<BaseType*>(reinterpret_cast<char*>(behaviour) + _offsets[type_id].load(std::memory_order_relaxed));
+    }
+
+private:
+    using CastFunction = void* (*)(Behaviour*);
+
+    template <typename BaseType>
+    static void* CastTo(Behaviour* behaviour) {
+        return dynamic_cast<BaseType*>(behaviour);
+    }
+
+    explicit SubtypeRegistry(CastFunction cast) : _cast(cast) {}
+
+    static constexpr std::size_t word_count = (BehaviourMask::capacity + 63) / 64;
+
+    const CastFunction _cast;
+    std::mutex _resolve_mutex;
+    std::atomic<std::uint64_t> _resolved[word_count] = {};
+    std::atomic<std::uint64_t> _derived[word_count] = {};
+    std::atomic<std::ptrdiff_t> _offsets[BehaviourMask::capacity] = {};
+};
+
+}
+#endif
@@ -1,217 +1,285 @@
 #include "ember/core/Behaviour.hpp"
+#include "ember/core/BehaviourHooks.hpp"
 #include <algorithm>
+#include <type_traits>
 
 namespace ember {
 /// Implementation of template methods for Game Object
 template <typename BehaviourSubType, typename... Args>
 GameObject& GameObject::withBehaviour(Args&&... args) {
-    auto type_index = std::type_index(typeid(BehaviourSubType));
-    _behaviours.emplace(std::pair<std::type_index, std::shared_ptr<Behaviour>>{type_index, std::make_shared<BehaviourSubType>(std::forward<Args>(args)...)});
-    _behaviours[type_index]->setGameObjectOwner(this);
-    auto _id_for_behaviour = _next_behaviour_index++;
-    _behaviours[type_index]->_id = Behaviour::id(_id, _id_for_behaviour);
-	if (_hasStarted) {
-		_behaviours[type_index]->onStart();
-	}
-    _behaviours_changed = true;
-    _get_behaviours_cache.clear();
+    auto behaviour = std::allocate_shared<BehaviourSubType>(PoolAllocator<BehaviourSubType>(), std::forward<Args>(args)...);
+    static_cast<Behaviour&>(*behaviour)._overridden_hooks = BehaviourHooks::OverriddenBy<BehaviourSubType>();
+    AddBehaviour(BehaviourType::Id<BehaviourSubType>(), std::move(behaviour));
 	return *this;
 }
 
 template <typename BehaviourSubType>
 bool GameObject::hasBehaviour() const {
-    return _behaviours.count(std::type_index(typeid(BehaviourSubType))) != 0;
+    return _behaviour_mask.test(BehaviourType::Id<BehaviourSubType>());
 }
 
 template <typename BehaviourSubType>
 BehaviourSubType& GameObject::refBehaviour() throw(std::invalid_argument) {
-    if (_behaviours.count(std::type_index(typeid(BehaviourSubType))) == 0) {
+    auto type_id = BehaviourType::Id<BehaviourSubType>();
+    if (!_behaviour_mask.test(type_id)) {
         throw std::invalid_argument("GameObject::refBehaviour - Behaviour " + std::string(typeid(BehaviourSubType).name()) + " not present in GameObject");
     }
-    return *(static_cast<BehaviourSubType*>(_behaviours[std::type_index(typeid(BehaviourSubType))].get()));
+    return *(static_cast<BehaviourSubType*>(BehaviourAt(type_id)));
 }
 
 template <typename BehaviourSubType>
 const BehaviourSubType& GameObject::refBehaviour() const throw(std::invalid_argument) {
-    if (_behaviours.count(std::type_index(typeid(BehaviourSubType))) == 0) {
+    auto type_id = BehaviourType::Id<BehaviourSubType>();
+    if (!_behaviour_mask.test(type_id)) {
         throw std::invalid_argument("GameObject::refBehaviour - Behaviour " + std::string(typeid(BehaviourSubType).name()) + " not present in GameObject");
     }
-    return *(static_cast<BehaviourSubType*>(_behaviours.at(std::type_index(typeid(BehaviourSubType))).get()));
+    return *(static_cast<const BehaviourSubType*>(BehaviourAt(type_id)));
 }
 
 template <typename BehaviourSubType>
 std::weak_ptr<BehaviourSubType> GameObject::getBehaviour() {
-    if (_behaviours.count(std::type_index(typeid(BehaviourSubType))) == 1) {
-        return std::static_pointer_cast<BehaviourSubType>(_behaviours[std::type_index(typeid(BehaviourSubType))]);
+    auto type_id = BehaviourType::Id<BehaviourSubType>();
+    if (_behaviour_mask.test(type_id)) {
+        return std::static_pointer_cast<BehaviourSubType>(_behaviours[_behaviour_mask.rank(type_id)].behaviour);
     }
     return std::weak_ptr<BehaviourSubType>();
 }
 
 template <typename BehaviourSubType>
 std::weak_ptr<const BehaviourSubType> GameObject::getBehaviour() const {
-    if (_behaviours.count(std::type_index(typeid(BehaviourSubType))) == 1) {
-        return std::static_pointer_cast<BehaviourSubType>(_behaviours.at(std::type_index(typeid(BehaviourSubType))));
+    auto type_id = BehaviourType::Id<BehaviourSubType>();
+    if (_behaviour_mask.test(type_id)) {
+        return std::static_pointer_cast<const BehaviourSubType>(_behaviours[_behaviour_mask.rank(type_id)].behaviour);
     }
-    return std::weak_ptr<BehaviourSubType>();
+    return std::weak_ptr<const BehaviourSubType>();
 }
 
 template <typename BehaviourSubType>
 std::vector<std::weak_ptr<BehaviourSubType>> GameObject::getBehaviours() {
-    auto behaviour_sub_type_index = std::type_index(typeid(BehaviourSubType));
+    SubtypeRegistry& registry = SubtypeRegistry::For<BehaviourSubType>();
+    ResolveSubtypes(registry);
     std::vector<std::weak_ptr<BehaviourSubType>> output;
-    if (_get_behaviours_cache.count(behaviour_sub_type_index) != 0) {
-        auto& cached_output = _get_behaviours_cache[behaviour_sub_type_index];
-        std::transform(cached_output.begin(), cached_output.end(), std::back_inserter(output),
-            [](const std::weak_ptr<Behaviour>& cached_behaviour) {
-                return std::dynamic_pointer_cast<BehaviourSubType>(cached_behaviour.lock());
-            });
-    } else {
-        for (const auto& behaviour : _behaviours) {
-            if(auto cast_component = std::dynamic_pointer_cast<BehaviourSubType>(behaviour.second))
-            {
-                output.push_back(cast_component);
-                _get_behaviours_cache[behaviour_sub_type_index].push_back(behaviour.second);
-            }
-        }
-    }
+    registry.Derived(_behaviour_mask).forEach([this, &registry, &output](BehaviourTypeId type_id) {
+        const auto& behaviour = _behaviours[_behaviour_mask.rank(type_id)].behaviour;
+        output.push_back(std::shared_ptr<BehaviourSubType>(behaviour, registry.Cast<BehaviourSubType>(behaviour.get(), type_id)));
+    });
     return output;
 }
 
 template <typename BehaviourSubType>
 std::vector<std::weak_ptr<const BehaviourSubType>> GameObject::getBehaviours() const {
-    auto behaviour_sub_type_index = std::type_index(typeid(BehaviourSubType));
+    SubtypeRegistry& registry = SubtypeRegistry::For<BehaviourSubType>();
+    ResolveSubtypes(registry);
     std::vector<std::weak_ptr<const BehaviourSubType>> output;
-    if (_get_behaviours_cache.count(behaviour_sub_type_index) != 0) {
-        auto& cached_output = _get_behaviours_cache[behaviour_sub_type_index];
-        std::transform(cached_output.begin(), cached_output.end(), std::back_inserter(output),
-            [](const std::weak_ptr<Behaviour>& cached_behaviour) {
-                return std::dynamic_pointer_cast<BehaviourSubType>(cached_behaviour.lock());
-            });
-    } else {
-        for (const auto& behaviour : _behaviours) {
-            if(auto cast_component = std::dynamic_pointer_cast<BehaviourSubType>(behaviour.second))
-            {
-                output.push_back(cast_component);
-                _get_behaviours_cache[behaviour_sub_type_index].push_back(behaviour.second);
-            }
-        }
-    }
+    registry.Derived(_behaviour_mask).forEach([this, &registry, &output](BehaviourTypeId type_id) {
+        const auto& behaviour = _behaviours[_behaviour_mask.rank(type_id)].behaviour;
+        output.push_back(std::shared_ptr<const BehaviourSubType>(behaviour, registry.Cast<const BehaviourSubType>(behaviour.get(), type_id)));
+    });
     return output;
 }
 
+template <typename BehaviourSubType>
+bool GameObject::hasBehaviours() const {
+    SubtypeRegistry& registry = SubtypeRegistry::For<BehaviourSubType>();
+    ResolveSubtypes(registry);
+    return registry.AnyDerived(_behaviour_mask);
+}
+
+template <typename BehaviourSubType, typename Function>
+void GameObject::forEachBehaviour(Function&& fun) {
+    SubtypeRegistry& registry = SubtypeRegistry::For<BehaviourSubType>();
+    ResolveSubtypes(registry);
+    registry.Derived(_behaviour_mask).forEach([this, &registry, &fun](BehaviourTypeId type_id) {
+        fun(*registry.Cast<BehaviourSubType>(BehaviourAt(type_id), type_id));
+    });
+}
+
+template <typename BehaviourSubType, typename Function>
+void GameObject::forEachBehaviour(Function&& fun) const {
+    SubtypeRegistry& registry = SubtypeRegistry::For<BehaviourSubType>();
+    ResolveSubtypes(registry);
+    registry.Derived(_behaviour_mask).forEach([this, &registry, &fun](BehaviourTypeId type_id) {
+        fun(*registry.Cast<const BehaviourSubType>(BehaviourAt(type_id), type_id));
+    });
+}
+
 template <typename EventType>
 void GameObject::CastEvent(const EventType& event) {
-    for (auto& behaviour : _behaviours) {
-        if(auto cast_component = std::dynamic_pointer_cast<addons::ListensTo<EventType>>(behaviour.second))
-        {
-            cast_component->Handle(event);
-        }
+    if (_sleeping) {
+        Wake();
     }
+    DeliverEvent(event);
+}
+
+template <typename EventType>
+void GameObject::DeliverEvent(const EventType& event) {
+    // Listener types are resolved once per event type (see SubtypeRegistry.hpp), so finding the listeners is a mask intersection
+    forEachBehaviour<addons::ListensTo<EventType>>([&event](addons::ListensTo<EventType>& listener) { listener.Handle(event); });
 }
 
 struct GameObject::SerializedCacheBase {
     virtual ~SerializedCacheBase() = default;
-    virtual bool IsCacheValid() = 0;
-    virtual void ClearCachedData() = 0;
+    // True if any of the behaviours responsible that don't report every change finds the cache dirty through IsSerializationDirty
+    virtual bool PolledBehaviourChanged() const = 0;
+    // Serialization cycle the cache was filled in, or last found valid in
+    std::uint64_t cycle = 0;
+    // Set if any of the behaviours responsible doesn't report every change (see Behaviour::setReportsSerializationChanges)
+    bool polled = false;
 };
 
 template <typename SerializableType>
 struct GameObject::SerializedCacheSub : public GameObject::SerializedCacheBase {
-    SerializedCacheSub(std::vector<std::weak_ptr<ember::addons::SerializableInto<SerializableType>>> responsible) :
-    _cached_data(nullptr), _behaviours_responsible(std::move(responsible)) {}
-    SerializedCacheSub(SerializableType to_cache,
-        std::vector<std::weak_ptr<ember::addons::SerializableInto<SerializableType>>> responsible) :
-    _cached_data(new SerializableType(std::move(to_cache))), _behaviours_responsible(std::move(responsible)) {}
-    ~SerializedCacheSub() = default;
-    bool IsCacheValid() override {
-        for (auto serializable_behaviour : _behaviours_responsible) {
-            if (serializable_behaviour.lock()->IsSerializationDirty(_cached_data)) {
-                return false;
+    struct Responsible {
+        Behaviour* behaviour;
+        addons::SerializableInto<SerializableType>* serializable;
+    };
+    bool PolledBehaviourChanged() const override {
+        for (const auto& responsible : behaviours_responsible) {
+            if (!responsible.behaviour->_reports_serialization_changes && responsible.serializable->IsSerializationDirty(cached_data)) {
+                return true;
             }
         }
-        return true;
+        return false;
     }
-    void ClearCachedData() override
-        { _cached_data = nullptr; }
-    inline bool HasCachedData() const
-        { return _cached_data != nullptr; }
-    inline const SerializableType& GetCachedData() const
-        { return *_cached_data; }
-    inline const std::vector<std::weak_ptr<ember::addons::SerializableInto<SerializableType>>>& GetBehavioursResponsible() const
-        { return _behaviours_responsible; }
-    std::shared_ptr<SerializableType> _cached_data;
-    std::vector<std::weak_ptr<ember::addons::SerializableInto<SerializableType>>> _behaviours_responsible;
+
+    std::shared_ptr<SerializableType> cached_data;
+    std::vector<Responsible> behaviours_responsible;
 };
 
-template <typename SerializableInto>
-bool GameObject::SerializeInto(SerializableInto& into) {
-    bool serialized_something = false;
-    auto type_index = std::type_index(typeid(SerializableInto));
-
-    if (_serialization_cache.count(type_index) != 0) {
-        SerializedCacheSub<SerializableInto>* cache =
-            dynamic_cast<SerializedCacheSub<SerializableInto>*>(_serialization_cache[type_index].get());
-        if (cache->HasCachedData()) {
-            into = cache->GetCachedData();
-            return true;
-        } else {
-            return false;
-        }
+template <typename SerializableType>
+GameObject::SerializedCacheSub<SerializableType>* GameObject::ValidSerializationCache(SerializationCaches& caches, bool partial) {
+    auto found = caches.find(std::type_index(typeid(SerializableType)));
+    if (found == caches.end()) {
+        return nullptr;
+    }
+    auto cache = static_cast<SerializedCacheSub<SerializableType>*>(found->second.get());
+    const auto cycle = CurrentSerializationCycle();
+    if (cache->cycle == cycle) {
+        return cache;
     }
+    // First use in this cycle. Changes reported since the cache was filled invalidate it. Behaviours polled through IsSerializationDirty were
+    // already asked as the previous cycles ended (see PollSerializationCaches)
+    if (_serialization_changed_cycle.load(std::memory_order_relaxed) > cache->cycle) {
+        caches.erase(found);
+        return nullptr;
+    }
+    cache->cycle = cycle;
+    if (partial) {
+        // Nothing changed since the previous partial serialization
+        cache->cached_data = nullptr;
+    }
+    return cache;
+}
 
-    auto serializable_behaviours = getBehaviours<ember::addons::SerializableInto<SerializableInto>>();
-    for (auto serializable_component : serializable_behaviours) {
-        serializable_component.lock()->SerializeInto(into);
-        serialized_something = true;
+template <typename SerializableType>
+GameObject::SerializedCacheSub<SerializableType>& GameObject::NewSerializationCache(SerializationCaches& caches) {
+    using Serializable = addons::SerializableInto<SerializableType>;
+    auto cache = new SerializedCacheSub<SerializableType>();
+    caches[std::type_index(typeid(SerializableType))].reset(cache);
+    cache->cycle = CurrentSerializationCycle();
+    SubtypeRegistry& registry = SubtypeRegistry::For<Serializable>();
+    ResolveSubtypes(registry);
+    registry.Derived(_behaviour_mask).forEach([this, &registry, cache](BehaviourTypeId type_id) {
+        auto behaviour = BehaviourAt(type_id);
+        cache->behaviours_responsible.push_back({ behaviour, registry.Cast<Serializable>(behaviour, type_id) });
+        cache->polled = cache->polled || !behaviour->_reports_serialization_changes;
+    });
+    if (cache->polled) {
+        ListPolledSerializationCaches();
     }
-    if (serialized_something) {
-        _serialization_cache.emplace(
-            std::pair<std::type_index, std::unique_ptr<SerializedCacheBase>>
-                {type_index,
-                    std::unique_ptr<SerializedCacheBase>(new SerializedCacheSub<SerializableInto>(into, std::move(serializable_behaviours)))});
+    return *cache;
+}
+
+template <typename SerializableType>
+bool GameObject::SerializeInto(SerializableType& into) {
+    static_assert(std::is_copy_assignable<SerializableType>::value,
+        "GameObject::SerializeInto - The type serialized into must be copy assignable, as the cached serialization is copied into 'into'");
+    static_assert(std::is_copy_constructible<SerializableType>::value,
+        "GameObject::SerializeInto - The type serialized into must be copy constructible, as the serialization is cached from 'into'");
+    SerializationCachesGuard guard(*this);
+    if (auto cache = ValidSerializationCache<SerializableType>(_serialization_cache, false)) {
+        if (!cache->cached_data) {
+            return false;
+        }
+        into = *cache->cached_data;
         return true;
-    } else {
-        _serialization_cache.emplace(
-            std::pair<std::type_index, std::unique_ptr<SerializedCacheBase>>
-                {type_index,
-                    std::unique_ptr<SerializedCacheBase>(new SerializedCacheSub<SerializableInto>(std::move(serializable_behaviours)))});
+    }
+    auto& cache = NewSerializationCache<SerializableType>(_serialization_cache);
+    if (cache.behaviours_responsible.empty()) {
         return false;
     }
+    for (const auto& responsible : cache.behaviours_responsible) {
+        responsible.serializable->SerializeInto(into);
+    }
+    cache.cached_data = std::make_shared<SerializableType>(into);
+    return true;
 }
 
-template <typename SerializableInto>
-bool GameObject::PartialSerializeInto(SerializableInto& into) {
-    bool serialized_something = false;
-    auto type_index = std::type_index(typeid(SerializableInto));
-
-    if (_partial_serialization_cache.count(type_index) != 0) {
-        SerializedCacheSub<SerializableInto>* cache =
-            dynamic_cast<SerializedCacheSub<SerializableInto>*>(_partial_serialization_cache[type_index].get());
-        if (cache->HasCachedData()) {
-            into = cache->GetCachedData();
-            return true;
-        } else {
+template <typename SerializableType>
+bool GameObject::PartialSerializeInto(SerializableType& into) {
+    static_assert(std::is_copy_assignable<SerializableType>::value,
+        "GameObject::PartialSerializeInto - The type serialized into must be copy assignable, as the cached serialization is copied into 'into'");
+    static_assert(std::is_copy_constructible<SerializableType>::value,
+        "GameObject::PartialSerializeInto - The type serialized into must be copy constructible, as the serialization is cached from 'into'");
+    SerializationCachesGuard guard(*this);
+    if (auto cache = ValidSerializationCache<SerializableType>(_partial_serialization_cache, true)) {
+        if (!cache->cached_data) {
             return false;
         }
+        into = *cache->cached_data;
+        return true;
+    }
+    auto& cache = NewSerializationCache<SerializableType>(_partial_serialization_cache);
+    bool serialized_something = false;
+    for (const auto& responsible : cache.behaviours_responsible) {
+        auto serialized_component = responsible.serializable->PartialSerializeInto(into);
+        serialized_something = serialized_something || serialized_component;
     }
+    if (serialized_something) {
+        cache.cached_data = std::make_shared<SerializableType>(into);
+    }
+    return serialized_something;
+}
+
+template <typename SerializableType>
+std::shared_ptr<const SerializableType> GameObject::SerializeShared() {
+    static_assert(std::is_default_constructible<SerializableType>::value,
+        "GameObject::SerializeShared - The type serialized into must be default constructible, as behaviours serialize into a new object");
+    SerializationCachesGuard guard(*this);
+    if (auto cache = ValidSerializationCache<SerializableType>(_serialization_cache, false)) {
+        return cache->cached_data;
+    }
+    auto& cache = NewSerializationCache<SerializableType>(_serialization_cache);
+    if (cache.behaviours_responsible.empty()) {
+        return nullptr;
+    }
+    auto serialized = std::make_shared<SerializableType>();
+    for (const auto& responsible : cache.behaviours_responsible) {
+        responsible.serializable->SerializeInto(*serialized);
+    }
+    cache.cached_data = serialized;
+    return serialized;
+}
 
-    auto serializable_behaviours = getBehaviours<ember::addons::SerializableInto<SerializableInto>>();
-    for (auto serializable_component : serializable_behaviours) {
-        auto serialized_component = serializable_component.lock()->PartialSerializeInto(into);
+template <typename SerializableType>
+std::shared_ptr<const SerializableType> GameObject::PartialSerializeShared() {
+    static_assert(std::is_default_constructible<SerializableType>::value,
+        "GameObject::PartialSerializeShared - The type serialized into must be default constructible, as behaviours serialize into a new object");
+    SerializationCachesGuard guard(*this);
+    if (auto cache = ValidSerializationCache<SerializableType>(_partial_serialization_cache, true)) {
+        return cache->cached_data;
+    }
+    auto& cache = NewSerializationCache<SerializableType>(_partial_serialization_cache);
+    auto serialized = std::make_shared<SerializableType>();
+    bool serialized_something = false;
+    for (const auto& responsible : cache.behaviours_responsible) {
+        auto serialized_component = responsible.serializable->PartialSerializeInto(*serialized);
         serialized_something = serialized_something || serialized_component;
     }
     if (serialized_something) {
-        _partial_serialization_cache.emplace(
-            std::pair<std::type_index, std::unique_ptr<SerializedCacheBase>>
-                {type_index,
-                    std::unique_ptr<SerializedCacheBase>(new SerializedCacheSub<SerializableInto>(into, std::move(serializable_behaviours)))});
-        return true;
-    } else {
-        _partial_serialization_cache.emplace(
-            std::pair<std::type_index, std::unique_ptr<SerializedCacheBase>>
-                {type_index,
-                    std::unique_ptr<SerializedCacheBase>(new SerializedCacheSub<SerializableInto>(std::move(serializable_behaviours)))});
-        return false;
+        cache.cached_data = serialized;
+        return serialized;
     }
+    return nullptr;
 }
 }
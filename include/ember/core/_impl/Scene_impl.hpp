@@ -1,4 +1,7 @@
 /// Implementation of template methods for Scene
+#include <algorithm>
+#include <iterator>
+#include <utility>
 namespace ember {
 
 template <typename SystemSubType, typename... Args>
@@ -7,6 +10,10 @@ void Scene::attachSystem(Args&&... args) {
     auto ret = _systems_in_scene.emplace(std::pair<std::type_index, std::shared_ptr<BaseSystem>>{type_index, std::make_shared<SystemSubType>(std::forward<Args>(args)...)});
     if (ret.second) {
         (*ret.first).second->_parent_scene = this;
+        _system_schedule_dirty = true;
+        _system_listeners.clear();
+        IndexSystemFilter(*(*ret.first).second);
+        (*ret.first).second->BindToScene();
         FilterAllGameObjectsThroughSystem((*ret.first).second);
     	if (_hasStarted) {
     		(*ret.first).second->onStart();
@@ -14,6 +21,30 @@ void Scene::attachSystem(Args&&... args) {
     }
 }
 
+template <typename... BehaviourTypes, typename Initializer>
+std::vector<GameObject::id> Scene::spawnBatch(std::size_t count, Prefab<BehaviourTypes...>, Initializer&& init) {
+    int reserve[] = { 0, (PoolFor<BehaviourTypes>().reserve(PoolFor<BehaviourTypes>().size() + count), 0)... };
+    (void)reserve;
+    auto objects = CreatePendingBatch(count);
+    for (std::size_t index = 0; index < count; index++) {
+        auto& game_object = *objects[index];
+        game_object._behaviours.reserve(sizeof...(BehaviourTypes));
+        // Objects pending addition take their behaviours immediately, without touching the scene
+        int attach[] = { 0, (game_object.withBehaviour<BehaviourTypes>(), 0)... };
+        (void)attach;
+        init(game_object, index);
+    }
+    return CommitPendingBatch(objects);
+}
+
+template <typename... BehaviourTypes>
+Query<BehaviourTypes...> Scene::query() {
+    BehaviourMask required;
+    int expand[] = { 0, (required.set(BehaviourType::Id<BehaviourTypes>()), 0)... };
+    (void)expand;
+    return Query<BehaviourTypes...>(IndexFor(required));
+}
+
 template <typename SystemSubType>
 bool Scene::hasSystem() const {
     return _systems_in_scene.count(std::type_index(typeid(SystemSubType))) != 0;
@@ -27,18 +58,225 @@ SystemSubType& Scene::refSystem() throw(std::invalid_argument) {
     return *(static_cast<SystemSubType*>(_systems_in_scene[std::type_index(typeid(SystemSubType))].get()));
 }
 
+template <typename... BehaviourTypes>
+void Scene::setBehaviourTypeOrder() {
+    _configured_type_order = { BehaviourType::Id<BehaviourTypes>()... };
+    _type_dispatch_order_dirty = true;
+}
+
+template <typename Hook>
+void Scene::DispatchPhase(BehaviourHooks::Phase phase, Hook&& hook) {
+    if (!_type_batched_updates) {
+        const auto& dispatch = _phase_dispatch[phase];
+        for (std::size_t position = 0; position < dispatch.size(); position++) {
+            hook(*dispatch[position]);
+        }
+        return;
+    }
+    if (_type_dispatch_order_dirty) {
+        RebuildTypeDispatchOrder();
+    }
+    const auto& typed_dispatch = _typed_phase_dispatch[phase];
+    for (auto type_id : _type_dispatch_order) {
+        if (type_id >= typed_dispatch.size()) {
+            continue;
+        }
+        const auto& dispatch = typed_dispatch[type_id];
+        for (std::size_t position = 0; position < dispatch.size(); position++) {
+            hook(*dispatch[position]);
+        }
+    }
+}
+
+template <typename BehaviourSubType>
+void Scene::reserveBehaviours(std::size_t count) {
+    PoolFor<BehaviourSubType>().reserve(count);
+}
+
+template <typename... BehaviourTypes, typename Function>
+void Scene::forEachWithBehaviours(Function&& fun) {
+    static_assert(sizeof...(BehaviourTypes) != 0, "Scene::forEachWithBehaviours - At least one behaviour type must be provided");
+    BehaviourMask required;
+    int expand[] = { 0, (required.set(BehaviourType::Id<BehaviourTypes>()), 0)... };
+    (void)expand;
+    if (!_archetype_storage_enabled) {
+        for (auto& game_object : _objects_in_scene) {
+            if (!game_object._pending_addition && game_object._behaviour_mask.contains(required)) {
+                fun(*static_cast<BehaviourTypes*>(game_object.BehaviourAt(BehaviourType::Id<BehaviourTypes>()))...);
+            }
+        }
+        return;
+    }
+    for (const auto& keypair : _archetypes) {
+        const auto& archetype = *keypair.second;
+        if (!archetype.signature().contains(required)) {
+            continue;
+        }
+        std::size_t columns[] = { archetype.ColumnOf(BehaviourType::Id<BehaviourTypes>())... };
+        for (const auto& chunk : archetype.chunks()) {
+            StreamArchetypeChunk<BehaviourTypes...>(*chunk, columns, fun, std::index_sequence_for<BehaviourTypes...>());
+        }
+    }
+}
+
+template <typename... BehaviourTypes, typename Function, std::size_t... Indices>
+void Scene::StreamArchetypeChunk(const Archetype::Chunk& chunk, const std::size_t* columns, Function& fun, std::index_sequence<Indices...>) {
+    Behaviour* const* column_data[] = { chunk.column(columns[Indices])... };
+    for (std::size_t row = 0; row < chunk.size; row++) {
+        fun(*static_cast<BehaviourTypes*>(column_data[Indices][row])...);
+    }
+}
+
 template <typename EventType>
 void Scene::BroadcastEvent(const EventType& event) {
-    std::map<GameObject::id, std::shared_ptr<GameObject>> traversal_copy(_objects_in_scene);
-    for (auto& game_object : traversal_copy) {
-        game_object.second->CastEvent<EventType>(event);
+    BeginPhase();
+    ForEachEventListener<EventType>([&event](addons::ListensTo<EventType>& listener) { listener.Handle(event); });
+    EndPhase();
+}
+
+template <typename EventType, typename Function>
+void Scene::ForEachEventListener(Function&& fun) {
+    using Listener = addons::ListensTo<EventType>;
+    SubtypeRegistry& registry = SubtypeRegistry::For<Listener>();
+    if (!registry.IsResolved(_behaviour_types_in_scene)) {
+        ResolveTypesInScene(registry);
     }
-    for (auto& system_in_scene : _systems_in_scene) {
-        if(auto cast_system = std::dynamic_pointer_cast<addons::ListensTo<EventType>>(system_in_scene.second))
-        {
-            cast_system->Handle(event);
+    // Structural changes are deferred until the phase ends, so the lists don't change while they're traversed
+    registry.Derived(_behaviour_types_in_scene).forEach([this, &registry, &fun](BehaviourTypeId type_id) {
+        for (auto behaviour : _behaviours_by_type[type_id]) {
+            fun(*registry.Cast<Listener>(behaviour, type_id));
         }
+    });
+    const auto& system_listeners = SystemListeners(typeid(Listener), [](BaseSystem& system) -> void* { return dynamic_cast<Listener*>(&system); });
+    for (auto listener : system_listeners) {
+        fun(*static_cast<Listener*>(listener));
     }
 }
 
+template <typename EventType>
+EventQueue<EventType>& Scene::EventQueueFor() {
+    const auto type_id = EventQueueBase::TypeId<EventType>();
+    if (_event_queues.size() <= type_id) {
+        _event_queues.resize(type_id + 1);
+    }
+    auto& queue = _event_queues[type_id];
+    if (!queue) {
+        queue.reset(new EventQueue<EventType>());
+    }
+    return static_cast<EventQueue<EventType>&>(*queue);
+}
+
+template <typename EventType>
+void Scene::QueueEvent(const EventType& event) {
+    std::lock_guard<std::mutex> lock(_event_queues_mutex);
+    EventQueueFor<EventType>().Queue(event);
+}
+
+template <typename EventType>
+void Scene::QueueEvent(GameObject::id target, const EventType& event) {
+    std::lock_guard<std::mutex> lock(_event_queues_mutex);
+    EventQueueFor<EventType>().Queue(target, event);
+}
+
+template <typename SerializableType>
+std::vector<std::pair<GameObject::id, std::shared_ptr<const SerializableType>>> Scene::serializeGameObjects() {
+    const auto object_ids = _objects_in_scene.handles();
+    std::vector<std::pair<GameObject::id, std::shared_ptr<const SerializableType>>> serialized(object_ids.size());
+    auto serialize_range = [this, &object_ids, &serialized](std::size_t begin, std::size_t end) {
+        for (std::size_t position = begin; position < end; position++) {
+            auto& game_object = *_objects_in_scene.get(object_ids[position]);
+            if (!game_object._pending_addition) {
+                serialized[position] = { object_ids[position], game_object.SerializeShared<SerializableType>() };
+            }
+        }
+    };
+    if (SerializesInParallel(object_ids.size())) {
+        _thread_pool->ParallelFor(0, object_ids.size(), _serialization_grain_size, serialize_range);
+    } else {
+        serialize_range(0, object_ids.size());
+    }
+    serialized.erase(std::remove_if(serialized.begin(), serialized.end(),
+        [](const std::pair<GameObject::id, std::shared_ptr<const SerializableType>>& entry) { return !entry.second; }), serialized.end());
+    return serialized;
+}
+
+template <typename EventType>
+bool Scene::PostEvent(const EventType& event) {
+    return _event_ingress->Post(GameObject::id(), event, &Scene::QueuePostedEvent<EventType>);
+}
+
+template <typename EventType>
+bool Scene::PostEvent(GameObject::id target, const EventType& event) {
+    return _event_ingress->Post(target, event, &Scene::QueuePostedEvent<EventType>);
+}
+
+template <typename EventType>
+void Scene::QueuePostedEvent(void* event, SlotHandle target, void* scene) {
+    auto& queue = static_cast<Scene*>(scene)->EventQueueFor<EventType>();
+    if (target.is_null()) {
+        queue.Queue(*static_cast<EventType*>(event));
+    } else {
+        queue.Queue(target, *static_cast<EventType*>(event));
+    }
+}
+
+template <typename EventType>
+void Scene::DeliverEventBatch(const addons::EventSpan<EventType>& events) {
+    ForEachEventListener<EventType>([&events](addons::ListensTo<EventType>& listener) { listener.HandleBatch(events); });
+}
+
+template <typename EventType>
+void Scene::DeliverEventBatch(GameObject::id target, const addons::EventSpan<EventType>& events) {
+    auto game_object = FindGameObject(target);
+    if (game_object == nullptr || game_object->_pending_removal) {
+        return;
+    }
+    if (game_object->_sleeping) {
+        game_object->Wake();
+    }
+    game_object->forEachBehaviour<addons::ListensTo<EventType>>(
+        [&events](addons::ListensTo<EventType>& listener) { listener.HandleBatch(events); });
+}
+
+template <typename EventType>
+bool EventQueue<EventType>::TakeQueued() {
+    _delivering_broadcast.swap(_broadcast);
+    _delivering_targeted.swap(_targeted);
+    return !_delivering_broadcast.empty() || !_delivering_targeted.empty();
+}
+
+template <typename EventType>
+void EventQueue<EventType>::Deliver(Scene& scene) {
+    if (!_delivering_broadcast.empty()) {
+        scene.DeliverEventBatch(addons::EventSpan<EventType>{ _delivering_broadcast.data(), _delivering_broadcast.size() });
+        _delivering_broadcast.clear();
+    }
+    if (!_delivering_targeted.empty()) {
+        // Stable, so each target still gets its events in the order they were queued
+        std::stable_sort(_delivering_targeted.begin(), _delivering_targeted.end(),
+            [](const std::pair<SlotHandle, EventType>& lhs, const std::pair<SlotHandle, EventType>& rhs) { return lhs.first < rhs.first; });
+        _grouped_events.clear();
+        for (auto& targeted : _delivering_targeted) {
+            _grouped_events.push_back(std::move(targeted.second));
+        }
+        for (std::size_t run_begin = 0; run_begin < _delivering_targeted.size();) {
+            const auto target = _delivering_targeted[run_begin].first;
+            std::size_t run_end = run_begin + 1;
+            while (run_end < _delivering_targeted.size() && _delivering_targeted[run_end].first == target) {
+                run_end++;
+            }
+            scene.DeliverEventBatch(target, addons::EventSpan<EventType>{ _grouped_events.data() + run_begin, run_end - run_begin });
+            run_begin = run_end;
+        }
+        _delivering_targeted.clear();
+        _grouped_events.clear();
+    }
+}
+
+// Defined here, as it needs the definition of Scene
+template <typename EventType>
+void GameObject::QueueEvent(const EventType& event) {
+    scene().QueueEvent(_id, event);
+}
+
 }
@@ -3,19 +3,253 @@
 // Class private methods
 private:
     void onStart();
-    void onPreUpdate();
+    void onPreUpdate(double deltaT);
     void onUpdate(double deltaT);
     void onPostUpdate();
 
-    void FilterGameObjectThroughAllSystems(const std::shared_ptr<GameObject>& object);
+    // Runs a single update cycle, flushing queued events at the configured points
+    void RunCycleStep(double deltaT);
+    inline void FlushEventsAt(EventFlushPoint point) {
+        if ((_event_flush_points & point) != 0) {
+            flushEvents();
+        }
+    }
+
+    // Brackets every traversal of the objects in scene. While a traversal is running, structural changes are queued as commands,
+    // which are applied once the outermost traversal ends.
+    void BeginPhase();
+    void EndPhase();
+    inline bool IsDeferringChanges() const { return _phase_depth.load(std::memory_order_relaxed) != 0; }
+
+    void QueueBehaviourAttachment(GameObject::id object_id, BehaviourTypeId type_id, std::shared_ptr<Behaviour> behaviour);
+
+    // Returns the object with the provided id, including objects waiting to be destroyed at the end of the current phase.
+    GameObject* FindGameObject(GameObject::id index);
+
+    // Calls 'phase' on every system in the scene, in parallel stages if the scene has worker threads
+    void RunSystems(const std::function<void(BaseSystem&)>& phase);
+    // Calls 'fun(chunk_begin, chunk_end)' on chunks of [begin, end) across the worker threads, buffering the structural changes of each chunk,
+    // which are then applied in chunk order
+    void ParallelFor(std::size_t begin, std::size_t end, std::size_t grain_size, const std::function<void(std::size_t, std::size_t)>& fun);
+    void RebuildSystemSchedule();
+
+    // Adds the behaviour to the dispatch list of every update phase whose hook it overrides, or removes it from them
+    void RegisterBehaviourHooks(Behaviour& behaviour);
+    void UnregisterBehaviourHooks(Behaviour& behaviour);
+    // Returns the dispatch list the behaviour belongs to for the phase, in the current dispatch mode
+    std::vector<Behaviour*>& DispatchListFor(std::size_t phase, const Behaviour& behaviour);
+    // Calls 'hook' on every behaviour registered for the phase, in type batches if enabled
+    template <typename Hook>
+    void DispatchPhase(BehaviourHooks::Phase phase, Hook&& hook);
+    void RebuildTypeDispatchOrder();
+
+    // Creates 'count' objects pending addition, reserving storage for all of them at once
+    std::vector<GameObject*> CreatePendingBatch(std::size_t count);
+    // Adds the batch to the scene, or queues it to be added at the end of the phase, returning the ids of its objects
+    std::vector<GameObject::id> CommitPendingBatch(const std::vector<GameObject*>& objects);
+    // Makes the objects of the batch take part in the scene: registers their hooks, places them in their archetypes and filters them
+    // through the systems, testing each system once for every distinct set of behaviour types in the batch, then starts them
+    void AddPendingBatch(const std::vector<GameObject::id>& ids);
+
+    // Puts the object to sleep or wakes it up, or queues the change if the scene is deferring structural changes
+    void SetGameObjectSleeping(GameObject::id index, bool sleeping);
+    // Notes a sleep or a wake of the object being queued. Returns false for a wake already queued and not yet applied: events cast on a
+    // sleeping object wake it, so it may be woken many times over a single phase
+    static bool NoteQueuedSleeping(GameObject& object, bool sleeping);
+    void ApplyGameObjectSleeping(GameObject& object, bool sleeping);
+
+    // Adds the behaviour to the scene's list of behaviours of its type, through which broadcast events reach their listeners, or removes it
+    void IndexBehaviour(Behaviour& behaviour);
+    void UnindexBehaviour(Behaviour& behaviour);
+    // True if whole scene serializations are split across the worker threads
+    inline bool SerializesInParallel(std::size_t object_count) const {
+        return _serialization_grain_size != 0 && _thread_pool && object_count > _serialization_grain_size;
+    }
+    // Polls the behaviours the caches of the objects in '_objects_with_polled_caches' depend on, as the serialization cycle ends
+    void PollSerializationCaches();
+    // Adds 'changes' to the behaviour's snapshot state, and its object to the snapshot dirty set. Has no effect until changes are tracked
+    void MarkSnapshotDirty(Behaviour& behaviour, unsigned char changes);
+    // Writes a frame for each of the object's behaviours serializable into snapshots. With 'changes_only', only for the behaviours with
+    // changes, partially if they were only flagged as changed. With 'consume_changes', clears the changes of the behaviours visited
+    void WriteSnapshotFrames(SnapshotWriter& writer, GameObject& object, bool changes_only, bool consume_changes);
+    // Calls 'fun(ListensTo<EventType>&)' on every behaviour and system listening to EventType
+    template <typename EventType, typename Function>
+    void ForEachEventListener(Function&& fun);
+    // Returns the queue of EventType events, creating it if needed. Must be called with '_event_queues_mutex' held
+    template <typename EventType>
+    EventQueue<EventType>& EventQueueFor();
+    template <typename EventType>
+    void QueueEvent(GameObject::id target, const EventType& event);
+    // Delivers a batch of queued events to every listener, or to the listeners of a single object
+    template <typename EventType>
+    void DeliverEventBatch(const addons::EventSpan<EventType>& events);
+    template <typename EventType>
+    void DeliverEventBatch(GameObject::id target, const addons::EventSpan<EventType>& events);
+    // Moves the events posted through the ingress to the queues, returning how many there were
+    std::size_t DrainEventIngress();
+    // Consumer of the events of the ingress, queueing 'event' on the scene passed as context
+    template <typename EventType>
+    static void QueuePostedEvent(void* event, SlotHandle target, void* scene);
+
+    // Resolves every behaviour type in the scene against the registry's base
+    void ResolveTypesInScene(SubtypeRegistry& registry);
+    // Systems deriving from the listener type of 'listener_type', cast to it through 'cast', and cached until a system is attached
+    const std::vector<void*>& SystemListeners(const std::type_info& listener_type, void* (*cast)(BaseSystem&));
+
+    // Erases the object from storage, and from its archetype
+    void DestroyGameObject(GameObject::id index);
+
+    // Moves the object to the archetype matching its current behaviours, if archetype storage is enabled
+    void UpdateArchetype(GameObject& object);
+    void RemoveFromArchetype(GameObject& object);
+
+    template <typename... BehaviourTypes, typename Function, std::size_t... Indices>
+    static void StreamArchetypeChunk(const Archetype::Chunk& chunk, const std::size_t* columns, Function& fun, std::index_sequence<Indices...>);
+
+    // Returns the query index for the types in 'required', creating it from the objects in the scene the first time
+    QueryIndex& IndexFor(const BehaviourMask& required);
+    // Adds the object to every query index it matches, when it joins the scene or wakes up
+    void AddToQueries(GameObject& object);
+    // Adds the object to the query indices that only match it now that it holds a behaviour of type 'type_id'
+    void AddToQueries(GameObject& object, BehaviourTypeId type_id);
+    void RemoveFromQueries(GameObject& object);
+
+    // Adds the system to the index of systems to test again when an object gains a behaviour type
+    void IndexSystemFilter(BaseSystem& system);
+
+    // Tests the object against the systems whose filters depend on the types it gained since it was last filtered,
+    // or against every system if it was never filtered
+    void FilterGameObjectThroughAllSystems(GameObject& object);
     void FilterAllGameObjectsThroughSystem(const std::shared_ptr<BaseSystem>& system);
 
     void Swap(Scene&& other);
 
 // Class Variables
 private:
-    GameObject::id _next_game_object_index = 0;
     bool _hasStarted{ false };
 
-    std::map<GameObject::id, std::shared_ptr<GameObject>> _objects_in_scene;
+    // Nested phases may begin and end from systems running in parallel (broadcasting events, for example), always within the phase
+    // running the systems, so only the outermost phase ever brings the depth back to 0
+    std::atomic<std::size_t> _phase_depth{ 0 };
+
+    double _fixed_timestep = 0;
+    std::size_t _max_fixed_steps = 5;
+    double _time_accumulator = 0;
+    // Position in the low discrepancy sequence used to stagger systems with a limited tick rate
+    std::size_t _tick_stagger_sequence = 0;
+
+    struct StructuralCommand {
+        enum class Type { AddGameObject, AddGameObjectBatch, RemoveGameObject, AttachBehaviour, SleepGameObject, WakeGameObject };
+        Type type;
+        GameObject::id object_id;
+        BehaviourTypeId behaviour_type = 0;
+        std::shared_ptr<Behaviour> behaviour = nullptr;
+        // Object added by an AddGameObject command buffered in DeferredChanges, not placed in storage yet
+        GameObject* buffered_object = nullptr;
+    };
+    // Structural changes made by a system running in a parallel stage, or by a chunk of one of its parallel traversals. They're kept apart
+    // from those of other threads, and applied in schedule order once the stage ends, so the outcome doesn't depend on thread timing.
+    // Objects added are only placed in storage then, which assigns their ids in that same order
+    struct DeferredChanges {
+        std::vector<StructuralCommand> commands;
+        std::vector<std::unique_ptr<GameObject>> objects;
+        // Objects of the batches queued by AddGameObjectBatch commands, in the order of the commands
+        std::deque<std::vector<GameObject*>> batches;
+    };
+    // Makes 'changes' the buffer of the structural changes made to the scene from this thread, for its lifetime
+    struct DeferredChangesScope {
+        DeferredChangesScope(Scene& scene, DeferredChanges& changes);
+        ~DeferredChangesScope();
+        Scene* previous_scene;
+        DeferredChanges* previous_changes;
+    };
+    // Returns the buffer of the structural changes made to the scene from this thread, or null if they go straight to the command buffer
+    DeferredChanges* TaskChanges() const;
+    // Queues the changes buffered by a chunk on the buffer of the task that split it, or on the command buffer if there's none
+    void MergeDeferredChanges(DeferredChanges& changes);
+    // Places the buffered objects in storage, and queues the buffered commands on the command buffer, in their order
+    void CommitDeferredChanges(DeferredChanges& changes);
+    GameObject::id PlaceBufferedObject(GameObject& object);
+    static thread_local Scene* _task_scene;
+    static thread_local DeferredChanges* _task_changes;
+    std::vector<StructuralCommand> _structural_commands;
+    std::vector<StructuralCommand> _applying_commands;
+    // Ids of the batches queued by AddGameObjectBatch commands, in the order of the commands
+    std::deque<std::vector<GameObject::id>> _pending_batches;
+    // Guards the command buffer, and insertions into the object storage, while systems run in parallel
+    std::mutex _structural_commands_mutex;
+
+    SlotMap<GameObject> _objects_in_scene;
+    // Objects whose behaviours changed since the last pre update, to filter through the systems again. Only appended to outside of phases,
+    // or while applying structural commands
+    std::vector<GameObject::id> _objects_to_refilter;
+    // Behaviours of the objects taking part in the update cycle, per update phase they override. Only changed outside of phases,
+    // through swap-removes
+    std::vector<Behaviour*> _phase_dispatch[BehaviourHooks::PhaseCount];
+    // With type batched updates, the dispatch lists are kept per behaviour type id instead, and visited in '_type_dispatch_order'
+    bool _type_batched_updates = false;
+    std::vector<std::vector<Behaviour*>> _typed_phase_dispatch[BehaviourHooks::PhaseCount];
+    std::vector<BehaviourTypeId> _configured_type_order;
+    std::vector<BehaviourTypeId> _type_first_use_order;
+    BehaviourMask _types_used;
+    std::vector<BehaviourTypeId> _type_dispatch_order;
+    bool _type_dispatch_order_dirty = false;
 	std::map<std::type_index, std::shared_ptr<BaseSystem>> _systems_in_scene;
+    std::map<std::type_index, std::vector<void*>> _system_listeners;
+    // Guards the listener cache, filled by the first broadcast of each event type, which may come from systems running in parallel
+    std::mutex _system_listeners_mutex;
+
+    // Queued events, per event type id (see EventQueueBase::TypeId)
+    std::vector<std::unique_ptr<EventQueueBase>> _event_queues;
+    std::mutex _event_queues_mutex;
+    // Queues with events taken by the flush in progress
+    std::vector<EventQueueBase*> _flushing_queues;
+    unsigned _event_flush_points = FlushAfterPreUpdate | FlushAfterUpdate | FlushAfterPostUpdate;
+    bool _flushing_events = false;
+    // Events posted from any thread, in a lock free ring (held by pointer, as it can't be moved along with the scene)
+    std::unique_ptr<EventIngress> _event_ingress{ new EventIngress() };
+
+    // Serialization cycles end in post update, once the behaviours' hooks ran. Serializations are cached for the rest of the cycle at least
+    // (see GameObject::SerializeInto)
+    std::atomic<std::uint64_t> _serialization_cycle{ 0 };
+    std::size_t _serialization_grain_size = 0;
+    // Objects holding serialization caches that depend on behaviours polled through IsSerializationDirty. Only those are walked as each
+    // serialization cycle ends, so objects whose caches are trusted until a change is reported, or that hold none, cost nothing.
+    // Appended to from any thread, as caches are filled
+    std::vector<GameObject::id> _objects_with_polled_caches;
+    std::mutex _polled_caches_mutex;
+    // Changes are tracked for delta snapshots once the first one is written. The dirty set holds each object with changes once, and may be
+    // appended to from any thread. Tombstones are only kept for objects that were part of a delta.
+    bool _snapshot_tracking = false;
+    std::vector<GameObject::id> _snapshot_dirty_objects;
+    std::mutex _snapshot_dirty_mutex;
+    std::vector<GameObject::id> _snapshot_tombstones;
+    // Versioned values changed, in the order of their latest change (held by pointer, as the values link to it across scene moves)
+    std::unique_ptr<ChangeJournal> _change_journal{ new ChangeJournal() };
+
+    // Behaviours of the objects in the scene (asleep or not), per behaviour type id, and the types with at least one behaviour
+    std::vector<std::vector<Behaviour*>> _behaviours_by_type;
+    BehaviourMask _behaviour_types_in_scene;
+
+    bool _archetype_storage_enabled = false;
+    std::map<BehaviourMask, std::unique_ptr<Archetype>> _archetypes;
+    std::size_t _archetype_moves = 0;
+
+    std::map<BehaviourMask, std::unique_ptr<QueryIndex>> _query_indices;
+    // Guards the creation of, and lookups into, the query indices, which may happen from systems running in parallel. Indices are only
+    // updated outside of phases, or while applying structural commands
+    std::mutex _query_indices_mutex;
+    // Query indices by each of the behaviour types they require
+    std::vector<std::vector<QueryIndex*>> _query_indices_by_behaviour_type;
+
+    // Systems with exact filters, indexed by the behaviour types their filters depend on, and systems to test on every change
+    std::vector<std::vector<BaseSystem*>> _systems_by_behaviour_type;
+    std::vector<BaseSystem*> _systems_filtering_every_change;
+    std::size_t _filter_pass = 0;
+
+    std::unique_ptr<ThreadPool> _thread_pool;
+    // Systems grouped in stages that can run in parallel, rebuilt before the next phase whenever a system is attached
+    std::vector<std::vector<BaseSystem*>> _system_stages;
+    // Structural changes buffered by each system of the stage running
+    std::deque<DeferredChanges> _stage_changes;
+    bool _system_schedule_dirty = true;
@@ -0,0 +1,35 @@
+// File containing the private API and internal workings of the ThreadPool, to avoid polluting the public API file.
+
+// Class private methods
+private:
+    struct Batch {
+        std::atomic<std::size_t> remaining{ 0 };
+        std::mutex exception_mutex;
+        std::exception_ptr exception = nullptr;
+    };
+
+    struct Job {
+        Task task;
+        Batch* batch;
+    };
+
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    void WorkerLoop(std::size_t worker_index);
+
+    // Pops a job from the queue at 'own_queue', or steals one from any other queue, and runs it. Returns false if every queue was empty.
+    bool TryRunOne(std::size_t own_queue);
+
+// Class Variables
+private:
+    // One queue per worker, plus a last one owned by threads outside the pool
+    std::vector<std::unique_ptr<WorkQueue>> _queues;
+    std::vector<std::thread> _workers;
+
+    std::atomic<std::size_t> _queued_jobs{ 0 };
+    std::atomic<bool> _stopping{ false };
+    std::mutex _sleep_mutex;
+    std::condition_variable _wake_workers;
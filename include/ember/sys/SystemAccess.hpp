@@ -0,0 +1,65 @@
+#ifndef Ember_SystemAccess_hpp
+#define Ember_SystemAccess_hpp
+
+#include <vector>
+#include <typeinfo>
+#include <typeindex>
+#include <algorithm>
+
+namespace ember {
+namespace sys {
+
+/// SystemAccess describes which Behaviour types a System reads and writes during its update phases.
+/// The Scene uses it to find which Systems can safely run at the same time: two systems conflict if either of them writes a type
+/// the other one reads or writes. A System that doesn't declare its access conflicts with every other system, and always runs alone.
+struct SystemAccess {
+    bool declared = false;
+    std::vector<std::type_index> reads;
+    std::vector<std::type_index> writes;
+
+    bool ConflictsWith(const SystemAccess& other) const {
+        if (!declared || !other.declared) {
+            return true;
+        }
+        auto touches = [](const SystemAccess& access, const std::type_index& type) {
+            return std::find(access.reads.begin(), access.reads.end(), type) != access.reads.end() ||
+                std::find(access.writes.begin(), access.writes.end(), type) != access.writes.end();
+        };
+        for (const auto& type : writes) {
+            if (touches(other, type)) {
+                return true;
+            }
+        }
+        for (const auto& type : other.writes) {
+            if (touches(*this, type)) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/// Reads and Writes are variadic template declarations, to be used after the filter in the template parameters of a System (System.hpp).
+/// Example: 'class MySystem : public System<RequiresBehaviours<Position, Velocity>, Reads<Velocity>, Writes<Position>>'.
+/// Declared access is trusted, it's not checked against what the System actually does. Systems must not touch undeclared Behaviour types
+/// (or other shared state) from their update phases, if the Scene is running with worker threads.
+template <class... Behaviours>
+struct Reads {
+    static void AppendTo(SystemAccess& access) {
+        int expand[] = { 0, (access.reads.push_back(std::type_index(typeid(Behaviours))), 0)... };
+        (void)expand;
+    }
+};
+
+template <class... Behaviours>
+struct Writes {
+    static void AppendTo(SystemAccess& access) {
+        int expand[] = { 0, (access.writes.push_back(std::type_index(typeid(Behaviours))), 0)... };
+        (void)expand;
+    }
+};
+
+}
+}
+
+#endif
@@ -8,13 +8,37 @@
 namespace ember {
 namespace sys {
 
+/// FilterMasks is the form System Filters are lowered to, so objects can be tested with a couple of mask operations, and a system is only
+/// tested again when an object gains a behaviour type the system's filter depends on.
+/// An object passes the masks if it holds every required type and none of the excluded ones. Filters that can't be fully expressed
+/// as masks (the polymorphic filters, and custom filters) clear 'exact': objects passing the masks are then also tested through the
+/// filter function, and the system is tested again whenever any behaviour is added to an object.
+struct FilterMasks {
+    bool exact = true;
+    BehaviourMask required;
+    BehaviourMask excluded;
+};
+
 /// System Filters available in this header are to be used as the template parameter in Systems (System.hpp).
 /// They Provide a way to filter GameObject into a system, primarily through Type checks.
 /// You can write your own SystemFilter if you wish, as long as they follow the API presented in struct 'SystemFilter'.
+/// 'AppendTo' is optional: filters without it are treated as inexact (see FilterMasks).
 struct SystemFilter {
     static const std::function<bool(const GameObject& object)>& GetFilterFun();
+    static void AppendTo(FilterMasks& masks);
 };
 
+/// Lowers 'Filter' into 'masks', through its AppendTo if it has one.
+template <typename Filter>
+auto AppendFilterMasks(FilterMasks& masks, int) -> decltype(Filter::AppendTo(masks), void()) {
+    Filter::AppendTo(masks);
+}
+
+template <typename Filter>
+void AppendFilterMasks(FilterMasks& masks, long) {
+    masks.exact = false;
+}
+
 
 /// RequiresBehaviour is a variadic template filter that ensure that all GameObjects in the System will have all the behaviours listed.
 /// Example: 'class MySystem : public System<RequiresBehaviours<MyBehaviour1, MyBehaviour2, MyBehaviour3>>'. Objects in MySystem will
@@ -29,6 +53,11 @@ public:
         return filter;
     }
 
+    static void AppendTo(FilterMasks& masks) {
+        int expand[] = { 0, (masks.required.set(BehaviourType::Id<RequiredBehaviours>()), 0)... };
+        (void)expand;
+    }
+
 private:
 
     template <class... Args>
@@ -60,6 +89,10 @@ public:
         return filter;
     }
 
+    static void AppendTo(FilterMasks& masks) {
+        masks.exact = false;
+    }
+
 private:
 
     template <class... Args>
@@ -69,7 +102,7 @@ private:
 
     template <class T, class... Args>
     static bool InternalFilterForChilds(const GameObject& object, PolymorphicRequiresBehaviours<T, Args...>) {
-        bool passes_filter_for_t = object.getBehaviours<T>().size() != 0;
+        bool passes_filter_for_t = object.hasBehaviours<T>();
         if (passes_filter_for_t) {
             return InternalFilterForChilds(object, PolymorphicRequiresBehaviours<Args...>());
         }
@@ -91,6 +124,11 @@ public:
         return filter;
     }
 
+    static void AppendTo(FilterMasks& masks) {
+        int expand[] = { 0, (masks.excluded.set(BehaviourType::Id<RequiredBehaviours>()), 0)... };
+        (void)expand;
+    }
+
 private:
 
     template <class... Args>
@@ -122,6 +160,10 @@ public:
         return filter;
     }
 
+    static void AppendTo(FilterMasks& masks) {
+        masks.exact = false;
+    }
+
 private:
 
     template <class... Args>
@@ -131,7 +173,7 @@ private:
 
     template <class T, class... Args>
     static bool InternalFilterForChilds(const GameObject& object, PolymorphicExcludesBehaviours<T, Args...>) {
-        bool passes_filter_for_t = object.getBehaviours<T>().size() == 0;
+        bool passes_filter_for_t = !object.hasBehaviours<T>();
         if (passes_filter_for_t) {
             return InternalFilterForChilds(object, PolymorphicExcludesBehaviours<Args...>());
         }
@@ -158,6 +200,11 @@ public:
         return filter;
     }
 
+    static void AppendTo(FilterMasks& masks) {
+        int expand[] = { 0, (AppendFilterMasks<RequiredBehaviours>(masks, 0), 0)... };
+        (void)expand;
+    }
+
 private:
     using FilterFunList = std::deque<std::function<bool(const GameObject& object)>>;
 
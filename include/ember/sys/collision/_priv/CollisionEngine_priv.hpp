@@ -6,8 +6,8 @@ protected:
     void onPreUpdate() override {} // No work to be done on PreUpdate
     void onUpdate(double /*deltaT*/) override;
     void onPostUpdate() override {} // No work to be done onUpdate
-    void onGameObjectAdded(const std::weak_ptr<GameObject>& weak_obj) override;
-    void onGameObjectRemoved(const std::weak_ptr<GameObject>&) override {}
+    void onGameObjectAdded(GameObject& object) override;
+    void onGameObjectRemoved(GameObject&) override {}
 
 private:
     std::vector<std::weak_ptr<BaseCollider>> GetCollisionShortlistForCollider(const std::shared_ptr<BaseCollider>& collider);
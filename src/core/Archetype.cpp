@@ -0,0 +1,52 @@
+#include "ember/core/Archetype.hpp"
+#include "ember/core/GameObject.hpp"
+#include "ember/core/Behaviour.hpp"
+
+using namespace ember;
+
+constexpr std::size_t Archetype::chunk_capacity;
+constexpr std::size_t Archetype::npos;
+
+std::size_t Archetype::Insert(GameObject& object) {
+    const std::size_t row = _size;
+    const std::size_t chunk_index = row / chunk_capacity;
+    if (chunk_index == _chunks.size()) {
+        _chunks.emplace_back(new Chunk(_column_count));
+    }
+    auto& chunk = *_chunks[chunk_index];
+    const std::size_t offset = chunk.size;
+    chunk.object_ids[offset] = object._id;
+    chunk.asleep[offset] = object._sleeping;
+    // The object's behaviours are sorted by type id, like the columns
+    std::size_t column_index = 0;
+    for (auto& behaviour : object._behaviours) {
+        chunk.column(column_index++)[offset] = behaviour.behaviour.get();
+    }
+    chunk.size++;
+    _size++;
+    return row;
+}
+
+SlotHandle Archetype::Remove(std::size_t row) {
+    const std::size_t last_row = _size - 1;
+    auto& last_chunk = *_chunks[last_row / chunk_capacity];
+    const std::size_t last_offset = last_row % chunk_capacity;
+    SlotHandle moved;
+    if (row != last_row) {
+        auto& chunk = *_chunks[row / chunk_capacity];
+        const std::size_t offset = row % chunk_capacity;
+        moved = last_chunk.object_ids[last_offset];
+        chunk.object_ids[offset] = moved;
+        chunk.asleep[offset] = last_chunk.asleep[last_offset];
+        for (std::size_t column_index = 0; column_index < _column_count; column_index++) {
+            chunk.column(column_index)[offset] = last_chunk.column(column_index)[last_offset];
+        }
+    }
+    last_chunk.size--;
+    _size--;
+    // Keeps one spare chunk around, so objects moving back and forth across a chunk boundary don't reallocate it every time
+    if (_chunks.size() > 1 && _chunks[_chunks.size() - 2]->size == 0) {
+        _chunks.pop_back();
+    }
+    return moved;
+}
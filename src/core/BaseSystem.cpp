@@ -1,66 +1,140 @@
 #include "ember/core/System.hpp"
+#include "ember/core/Scene.hpp"
+#include <cmath>
 
 namespace ember {
 
-void BaseSystem::FilterGameObject(const std::shared_ptr<GameObject>& shared_obj) {
-    if (_filter_fun(*shared_obj)) {
-        if (_managed_objects.count(shared_obj->object_id()) == 0) {
-            onGameObjectAdded(shared_obj);
+void BaseSystem::setTickRate(double ticks_per_second) {
+    _tick_period = ticks_per_second > 0 ? 1000.0 / ticks_per_second : 0;
+    _tick_clock_started = false;
+}
+
+void BaseSystem::AdvanceTickClock(double deltaT, double stagger) {
+    if (_tick_period <= 0) {
+        _ticking = true;
+        _tick_delta = deltaT;
+        return;
+    }
+    if (!_tick_clock_started) {
+        _tick_clock = stagger * _tick_period;
+        _elapsed_since_tick = 0;
+        _tick_clock_started = true;
+    }
+    _tick_clock += deltaT;
+    _elapsed_since_tick += deltaT;
+    _ticking = _tick_clock >= _tick_period;
+    if (_ticking) {
+        _tick_delta = _elapsed_since_tick;
+        _elapsed_since_tick = 0;
+        // Never runs more than once per update cycle, dropping any backlog, while keeping the system's place in the period
+        _tick_clock = std::fmod(_tick_clock, _tick_period);
+    }
+}
+
+bool BaseSystem::PassesFilter(const GameObject& object) const {
+    const auto& mask = object.behaviour_mask();
+    return mask.contains(_filter_masks.required) && !mask.intersects(_filter_masks.excluded) && (_filter_masks.exact || _filter_fun(object));
+}
+
+void BaseSystem::FilterGameObject(GameObject& object) {
+    const auto object_id = object.object_id();
+    // Sleeping objects are announced and removed as usual, with their ids moved out of '_managed_objects' around the calls
+    if (PassesFilter(object)) {
+        if (!_managed_objects.contains(object_id) && !_sleeping_objects.contains(object_id)) {
+            onGameObjectAdded(object);
+            if (object.isSleeping() && _managed_objects.erase(object_id)) {
+                _sleeping_objects.insert(object_id);
+            }
         }
     } else {
-        onGameObjectRemoved(shared_obj);
+        if (_sleeping_objects.erase(object_id)) {
+            _managed_objects.insert(object_id);
+        }
+        onGameObjectRemoved(object);
     }
 }
 
-void BaseSystem::onGameObjectAdded(const std::weak_ptr<GameObject>& weak_obj) {
-    if (auto shared_obj = weak_obj.lock()) {
-        _managed_objects[shared_obj->object_id()] = weak_obj;
-    }
+void BaseSystem::onGameObjectAdded(GameObject& object) {
+    _managed_objects.insert(object.object_id());
 }
 
-void BaseSystem::onGameObjectRemoved(const std::weak_ptr<GameObject>& weak_obj) {
-    if (auto shared_obj = weak_obj.lock()) {
-        _managed_objects.erase(shared_obj->object_id());
-    }
+void BaseSystem::onGameObjectRemoved(GameObject& object) {
+    _managed_objects.erase(object.object_id());
 }
 
-void BaseSystem::onPreUpdate() {
-    for (auto iter = _managed_objects.begin(); iter != _managed_objects.end(); ) {
-        if (auto shared_obj = iter->second.lock()) {
-            onPreUpdate(*shared_obj);
-            iter++;
-        } else {
-            auto to_erase = iter;
-            iter++;
-            _managed_objects.erase(to_erase);
+void BaseSystem::ForEachManagedObject(const std::function<void(GameObject&)>& fun) {
+    auto thread_pool = scene()._thread_pool.get();
+    if (_parallel_grain_size == 0 || thread_pool == nullptr || _managed_objects.size() <= _parallel_grain_size) {
+        for (std::size_t position = 0; position < _managed_objects.size();) {
+            if (auto object = scene().FindGameObject(_managed_objects[position])) {
+                fun(*object);
+                position++;
+            } else {
+                _managed_objects.erase_at(position);
+            }
         }
+        return;
     }
-}
 
-void BaseSystem::onUpdate(double deltaT) {
-    for (auto iter = _managed_objects.begin(); iter != _managed_objects.end();) {
-        if (auto shared_obj = iter->second.lock()) {
-            onUpdate(deltaT, *shared_obj);
-            iter++;
-        } else {
-            auto to_erase = iter;
-            iter++;
-            _managed_objects.erase(to_erase);
+    // Each chunk collects the ids of the objects it found no longer existing, which are only removed once every chunk is done,
+    // as the set can't change while it's being traversed.
+    std::vector<std::vector<GameObject::id>> expired_per_chunk((_managed_objects.size() + _parallel_grain_size - 1) / _parallel_grain_size);
+    scene().ParallelFor(0, _managed_objects.size(), _parallel_grain_size,
+        [this, &fun, &expired_per_chunk](std::size_t chunk_begin, std::size_t chunk_end) {
+            auto& expired = expired_per_chunk[chunk_begin / _parallel_grain_size];
+            for (std::size_t position = chunk_begin; position < chunk_end; position++) {
+                if (auto object = scene().FindGameObject(_managed_objects[position])) {
+                    fun(*object);
+                } else {
+                    expired.push_back(_managed_objects[position]);
+                }
+            }
+        });
+    for (const auto& expired : expired_per_chunk) {
+        for (const auto& object_id : expired) {
+            _managed_objects.erase(object_id);
         }
     }
 }
 
-void BaseSystem::onPostUpdate() {
-    for (auto iter = _managed_objects.begin(); iter != _managed_objects.end();) {
-        if (auto shared_obj = iter->second.lock()) {
-            onPostUpdate(*shared_obj);
-            iter++;
-        } else {
-            auto to_erase = iter;
-            iter++;
-            _managed_objects.erase(to_erase);
+bool BaseSystem::MatchingArchetypes(std::vector<const Archetype*>& archetypes) const {
+    const auto& scene = *_parent_scene;
+    if (!scene._archetype_storage_enabled || !_filter_masks.exact) {
+        return false;
+    }
+    for (const auto& keypair : scene._archetypes) {
+        const auto& signature = keypair.first;
+        if (signature.contains(_filter_masks.required) && !signature.intersects(_filter_masks.excluded)) {
+            archetypes.push_back(keypair.second.get());
         }
     }
+    return true;
+}
+
+const QueryIndex& BaseSystem::SceneQueryIndex(const BehaviourMask& required) {
+    return scene().IndexFor(required);
+}
+
+void BaseSystem::ForEachRowRange(std::size_t row_count, const std::function<void(std::size_t, std::size_t)>& fun) {
+    auto thread_pool = scene()._thread_pool.get();
+    if (_parallel_grain_size == 0 || thread_pool == nullptr || row_count <= _parallel_grain_size) {
+        fun(0, row_count);
+        return;
+    }
+    // Rows only change between phases, so they can be split across workers as they are
+    scene().ParallelFor(0, row_count, _parallel_grain_size, fun);
+}
+
+void BaseSystem::onPreUpdate() {
+    ForEachManagedObject([this](GameObject& object) { onPreUpdate(object); });
+}
+
+void BaseSystem::onUpdate(double deltaT) {
+    ForEachManagedObject([this, deltaT](GameObject& object) { onUpdate(deltaT, object); });
+}
+
+void BaseSystem::onPostUpdate() {
+    ForEachManagedObject([this](GameObject& object) { onPostUpdate(object); });
 }
 
 }
@@ -0,0 +1,14 @@
+#include "ember/core/Behaviour.hpp"
+#include "ember/core/Scene.hpp"
+
+using namespace ember;
+
+constexpr unsigned char Behaviour::snapshot_changed;
+constexpr unsigned char Behaviour::snapshot_unsent;
+
+void Behaviour::MarkSerializationDirty() {
+    if (_gameObjectOwner != nullptr) {
+        _gameObjectOwner->MarkSerializationChanged();
+        _gameObjectOwner->scene().MarkSnapshotDirty(*this, snapshot_changed);
+    }
+}
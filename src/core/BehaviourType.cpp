@@ -0,0 +1,43 @@
+#include <mutex>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include "ember/core/BehaviourType.hpp"
+
+using namespace ember;
+
+constexpr std::size_t BehaviourMask::capacity;
+constexpr std::size_t BehaviourMask::word_count;
+
+namespace {
+std::mutex& RegistryMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::vector<const std::type_info*>& RegisteredTypes() {
+    static std::vector<const std::type_info*> types;
+    return types;
+}
+}
+
+std::size_t BehaviourType::Count() {
+    std::lock_guard<std::mutex> lock(RegistryMutex());
+    return RegisteredTypes().size();
+}
+
+const std::type_info& BehaviourType::Info(BehaviourTypeId id) {
+    std::lock_guard<std::mutex> lock(RegistryMutex());
+    return *RegisteredTypes().at(id);
+}
+
+BehaviourTypeId BehaviourType::Register(const std::type_info& info) {
+    std::lock_guard<std::mutex> lock(RegistryMutex());
+    auto& types = RegisteredTypes();
+    if (types.size() == BehaviourMask::capacity) {
+        throw std::length_error("BehaviourType - Too many behaviour types registering " + std::string(info.name()) +
+            ", raise EMBER_MAX_BEHAVIOUR_TYPES above " + std::to_string(BehaviourMask::capacity));
+    }
+    types.push_back(&info);
+    return static_cast<BehaviourTypeId>(types.size() - 1);
+}
@@ -0,0 +1,77 @@
+#include "ember/core/ChangeJournal.hpp"
+#include "ember/core/Scene.hpp"
+
+using namespace ember;
+
+namespace {
+std::atomic<std::uint64_t>& LatestVersion() {
+    static std::atomic<std::uint64_t> version{ 0 };
+    return version;
+}
+}
+
+JournalEntry::~JournalEntry() {
+    if (_journal != nullptr) {
+        std::lock_guard<std::mutex> lock(_journal->_mutex);
+        _journal->Unlink(*this);
+    }
+}
+
+std::uint64_t JournalEntry::CurrentVersion() {
+    return LatestVersion().load(std::memory_order_acquire);
+}
+
+void JournalEntry::RecordChange() {
+    ChangeJournal* journal = nullptr;
+    if (_owner->is_attached()) {
+        journal = _owner->game_object().scene()._change_journal.get();
+    }
+    if (journal == nullptr) {
+        _version.store(LatestVersion().fetch_add(1, std::memory_order_acq_rel) + 1, std::memory_order_release);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(journal->_mutex);
+    journal->Record(*this);
+}
+
+ChangeJournal::~ChangeJournal() {
+    for (auto entry = _head; entry != nullptr; entry = entry->_next) {
+        entry->_journal = nullptr;
+    }
+}
+
+void ChangeJournal::Record(JournalEntry& entry) {
+    // Handed out under the journal's lock, so versions increase along the journal
+    entry._version.store(LatestVersion().fetch_add(1, std::memory_order_acq_rel) + 1, std::memory_order_release);
+    if (entry._journal == this && _tail == &entry) {
+        return;
+    }
+    if (entry._journal == this) {
+        Unlink(entry);
+    }
+    entry._journal = this;
+    entry._previous = _tail;
+    entry._next = nullptr;
+    if (_tail != nullptr) {
+        _tail->_next = &entry;
+    } else {
+        _head = &entry;
+    }
+    _tail = &entry;
+}
+
+void ChangeJournal::Unlink(JournalEntry& entry) {
+    if (entry._previous != nullptr) {
+        entry._previous->_next = entry._next;
+    } else {
+        _head = entry._next;
+    }
+    if (entry._next != nullptr) {
+        entry._next->_previous = entry._previous;
+    } else {
+        _tail = entry._previous;
+    }
+    entry._journal = nullptr;
+    entry._previous = nullptr;
+    entry._next = nullptr;
+}
@@ -0,0 +1,90 @@
+#include "ember/core/EventIngress.hpp"
+
+using namespace ember;
+
+constexpr std::size_t EventIngress::inline_event_size;
+constexpr std::size_t EventIngress::default_capacity;
+
+namespace {
+std::size_t RoundUpToPowerOfTwo(std::size_t value) {
+    std::size_t power = 1;
+    while (power < value) {
+        power <<= 1;
+    }
+    return power;
+}
+}
+
+EventIngress::EventIngress(std::size_t capacity) : _mask(RoundUpToPowerOfTwo(capacity < 2 ? 2 : capacity) - 1), _cells(new Cell[_mask + 1]) {
+    for (std::size_t position = 0; position <= _mask; position++) {
+        _cells[position].sequence.store(position, std::memory_order_relaxed);
+    }
+}
+
+EventIngress::~EventIngress() {
+    // Events never drained are destroyed without being consumed
+    for (;;) {
+        auto& cell = _cells[_dequeue_position & _mask];
+        if (cell.sequence.load(std::memory_order_acquire) != _dequeue_position + 1) {
+            break;
+        }
+        if (cell.consume != nullptr) {
+            cell.destroy(cell.event, cell.allocated);
+        }
+        _dequeue_position++;
+    }
+}
+
+EventIngress::Cell* EventIngress::Claim(std::size_t& position) {
+    position = _enqueue_position.load(std::memory_order_relaxed);
+    for (;;) {
+        auto& cell = _cells[position & _mask];
+        const auto sequence = cell.sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+        if (difference == 0) {
+            if (_enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                return &cell;
+            }
+        } else if (difference < 0) {
+            // The cell still holds the event posted one lap earlier: the ring is full
+            return nullptr;
+        } else {
+            position = _enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+std::size_t EventIngress::Drain(void* context) {
+    const auto depth = _enqueue_position.load(std::memory_order_relaxed) - _dequeue_position;
+    if (depth > _peak_depth.load(std::memory_order_relaxed)) {
+        _peak_depth.store(depth, std::memory_order_relaxed);
+    }
+    std::size_t drained = 0;
+    for (;;) {
+        auto& cell = _cells[_dequeue_position & _mask];
+        if (cell.sequence.load(std::memory_order_acquire) != _dequeue_position + 1) {
+            break;
+        }
+        if (cell.consume != nullptr) {
+            cell.consume(cell.event, cell.target, context);
+            cell.destroy(cell.event, cell.allocated);
+        }
+        // Hands the cell back to the producers, for the next lap
+        cell.sequence.store(_dequeue_position + _mask + 1, std::memory_order_release);
+        _dequeue_position++;
+        drained++;
+    }
+    _drained.fetch_add(drained, std::memory_order_relaxed);
+    return drained;
+}
+
+EventIngressStats EventIngress::stats() const {
+    EventIngressStats stats;
+    stats.capacity = _mask + 1;
+    stats.posted = _enqueue_position.load(std::memory_order_relaxed);
+    stats.drained = _drained.load(std::memory_order_relaxed);
+    stats.depth = stats.posted > stats.drained ? stats.posted - stats.drained : 0;
+    stats.peak_depth = _peak_depth.load(std::memory_order_relaxed);
+    stats.rejected = _rejected.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,9 @@
+#include <atomic>
+#include "ember/core/EventQueue.hpp"
+
+using namespace ember;
+
+std::size_t EventQueueBase::NextTypeId() {
+    static std::atomic<std::size_t> next_id{ 0 };
+    return next_id++;
+}
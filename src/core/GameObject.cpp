@@ -1,4 +1,4 @@
-#include <set>
+#include <thread>
 #include "ember/core/GameObject.hpp"
 #include "ember/core/Scene.hpp"
 #include "ember/core/Behaviour.hpp"
@@ -9,8 +9,9 @@ GameObject::GameObject() {}
 
 GameObject::GameObject(GameObject&& other) : _hasStarted(other._hasStarted){
 	_behaviours.swap(other._behaviours);
+	std::swap(_behaviour_mask, other._behaviour_mask);
 	for (auto& behaviour : _behaviours) {
-		behaviour.second->setGameObjectOwner(this);
+		behaviour.behaviour->setGameObjectOwner(this);
 	}
 }
 
@@ -20,8 +21,9 @@ GameObject::~GameObject() {
 
 GameObject& GameObject::operator=(GameObject&& other) {
 	_behaviours.swap(other._behaviours);
+	std::swap(_behaviour_mask, other._behaviour_mask);
 	for (auto& behaviour : _behaviours) {
-		behaviour.second->setGameObjectOwner(this);
+		behaviour.behaviour->setGameObjectOwner(this);
 	}
 	return *this;
 }
@@ -29,57 +31,144 @@ GameObject& GameObject::operator=(GameObject&& other) {
 void GameObject::onStart() {
 	_hasStarted = true;
 	for (auto& behaviour : _behaviours) {
-		behaviour.second->onStart();
+		behaviour.behaviour->onStart();
 	}
 }
-void GameObject::onPreUpdate() {
-	for (auto& behaviour : _behaviours) {
-		behaviour.second->onPreUpdate();
-	}
-}
-void GameObject::onUpdate(double deltaT) {
-	for (auto& behaviour : _behaviours) {
-		behaviour.second->onUpdate(deltaT);
-	}
-}
-void GameObject::onPostUpdate() {
-	for (auto& behaviour : _behaviours) {
-		behaviour.second->onPostUpdate();
-	}
-    CheckForCacheInvalidation();
-}
 
 void GameObject::onEnd() {
     if (_hasEnded) {
         return;
     }
     for (auto& behaviour : _behaviours) {
-        behaviour.second->onEnd();
-        behaviour.second->setGameObjectOwner(nullptr);
+        behaviour.behaviour->onEnd();
+        behaviour.behaviour->setGameObjectOwner(nullptr);
     }
     _hasEnded = true;
 }
 
+void GameObject::AddBehaviour(BehaviourTypeId type_id, std::shared_ptr<Behaviour> behaviour) {
+    if (_parent_scene != nullptr && _parent_scene->IsDeferringChanges() && !_pending_addition) {
+        _parent_scene->QueueBehaviourAttachment(_id, type_id, std::move(behaviour));
+    } else {
+        AttachBehaviour(type_id, std::move(behaviour));
+    }
+}
+
+void GameObject::AttachBehaviour(BehaviourTypeId type_id, std::shared_ptr<Behaviour> behaviour) {
+    if (_behaviour_mask.test(type_id)) {
+        return;
+    }
+    auto position = _behaviours.insert(_behaviours.begin() + _behaviour_mask.rank(type_id), BehaviourEntry{type_id, std::move(behaviour)});
+    _behaviour_mask.set(type_id);
+    auto& new_behaviour = position->behaviour;
+    new_behaviour->setGameObjectOwner(this);
+    // The caches don't account for the new behaviour
+    _serialization_cache.clear();
+    _partial_serialization_cache.clear();
+    new_behaviour->_type_id = type_id;
+    new_behaviour->_id = Behaviour::id(_id, _next_behaviour_index++);
+	if (_hasStarted) {
+		new_behaviour->onStart();
+	}
+    _changed_behaviour_types.set(type_id);
+    if (_parent_scene != nullptr && !_pending_addition && !_behaviours_changed) {
+        _parent_scene->_objects_to_refilter.push_back(_id);
+    }
+    _behaviours_changed = true;
+    if (_parent_scene != nullptr && !_pending_addition) {
+        _parent_scene->UpdateArchetype(*this);
+        _parent_scene->IndexBehaviour(*new_behaviour);
+        if (!_sleeping) {
+            _parent_scene->RegisterBehaviourHooks(*new_behaviour);
+            _parent_scene->AddToQueries(*this, type_id);
+        }
+    }
+}
+
+void GameObject::ResolveSubtypes(SubtypeRegistry& registry) const {
+    if (registry.IsResolved(_behaviour_mask)) {
+        return;
+    }
+    for (const auto& entry : _behaviours) {
+        registry.Resolve(entry.type_id, entry.behaviour.get());
+    }
+}
+
+void GameObject::Sleep() {
+    // Objects added by systems running in parallel have no id until they're placed in the scene's storage (see Scene::addGameObject)
+    if (_id.is_null()) {
+        _sleeping = true;
+        return;
+    }
+    scene().SetGameObjectSleeping(_id, true);
+}
+
+void GameObject::Wake() {
+    if (_id.is_null()) {
+        _sleeping = false;
+        return;
+    }
+    scene().SetGameObjectSleeping(_id, false);
+}
+
 void GameObject::Destroy() {
+    if (_id.is_null()) {
+        _pending_removal = true;
+        return;
+    }
     scene().removeGameObject(object_id());
 }
 
-void GameObject::CheckForCacheInvalidation() {
-    std::set<std::type_index> keys_to_remove;
-    for (const auto& keypair : _serialization_cache) {
-        if (!keypair.second->IsCacheValid()) {
-            keys_to_remove.insert(keypair.first);
-        }
+std::uint64_t GameObject::CurrentSerializationCycle() const {
+    return _parent_scene != nullptr ? _parent_scene->_serialization_cycle.load(std::memory_order_relaxed) : 0;
+}
+
+void GameObject::MarkSerializationChanged() {
+    _serialization_changed_cycle.store(CurrentSerializationCycle() + 1, std::memory_order_relaxed);
+}
+
+void GameObject::ListPolledSerializationCaches() {
+    if (_parent_scene == nullptr || _polled_caches_listed.exchange(true, std::memory_order_relaxed)) {
+        return;
     }
-    for (const auto& keypair : _partial_serialization_cache) {
-        if (!keypair.second->IsCacheValid()) {
-            keys_to_remove.insert(keypair.first);
-        } else {
-            keypair.second->ClearCachedData();
+    std::lock_guard<std::mutex> lock(_parent_scene->_polled_caches_mutex);
+    _parent_scene->_objects_with_polled_caches.push_back(_id);
+}
+
+bool GameObject::PollSerializationCaches() {
+    SerializationCachesGuard guard(*this);
+    bool polled = false;
+    for (auto caches : { &_serialization_cache, &_partial_serialization_cache }) {
+        for (auto cache = caches->begin(); cache != caches->end();) {
+            if (cache->second->polled && cache->second->PolledBehaviourChanged()) {
+                cache = caches->erase(cache);
+            } else {
+                polled = polled || cache->second->polled;
+                ++cache;
+            }
         }
     }
-    for (const auto& key : keys_to_remove) {
-        _serialization_cache.erase(key);
-        _partial_serialization_cache.erase(key);
+    return polled;
+}
+
+GameObject::SerializationCachesGuard::SerializationCachesGuard(GameObject& object) : object(object) {
+    const auto self = std::this_thread::get_id();
+    // Only this thread can have stored its own id, so it already holds the lock
+    if (object._serialization_caches_owner.load(std::memory_order_relaxed) == self) {
+        object._serialization_caches_depth++;
+        return;
+    }
+    // Only contended when the same object is serialized from several threads, so spinning beats the size of a mutex in every object
+    auto unowned = std::thread::id();
+    while (!object._serialization_caches_owner.compare_exchange_weak(unowned, self, std::memory_order_acquire, std::memory_order_relaxed)) {
+        unowned = std::thread::id();
+        std::this_thread::yield();
+    }
+    object._serialization_caches_depth = 1;
+}
+
+GameObject::SerializationCachesGuard::~SerializationCachesGuard() {
+    if (--object._serialization_caches_depth == 0) {
+        object._serialization_caches_owner.store(std::thread::id(), std::memory_order_release);
     }
 }
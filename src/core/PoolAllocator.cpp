@@ -0,0 +1,88 @@
+#include "ember/core/PoolAllocator.hpp"
+
+using namespace ember;
+
+constexpr std::size_t BlockPool::block_alignment;
+
+namespace {
+constexpr std::size_t smallest_size_class = 32;
+constexpr std::size_t size_class_count = 8;
+
+// Like the pools of PoolFor, size class pools are never destroyed
+BlockPool** CreateSizeClassPools() {
+    static BlockPool* pools[size_class_count];
+    for (std::size_t size_class = 0; size_class < size_class_count; size_class++) {
+        std::size_t block_size = smallest_size_class << size_class;
+        pools[size_class] = new BlockPool(block_size, block_size <= 256 ? 256 : 65536 / block_size);
+    }
+    return pools;
+}
+}
+
+BlockPool* ember::SizeClassPoolFor(std::size_t bytes) {
+    static BlockPool** pools = CreateSizeClassPools();
+    std::size_t block_size = smallest_size_class;
+    for (std::size_t size_class = 0; size_class < size_class_count; size_class++, block_size <<= 1) {
+        if (bytes <= block_size) {
+            return pools[size_class];
+        }
+    }
+    return nullptr;
+}
+
+BlockPool::BlockPool(std::size_t block_size, std::size_t blocks_per_slab)
+    : _block_size(block_size < sizeof(FreeBlock) ? sizeof(FreeBlock) : block_size), _blocks_per_slab(blocks_per_slab) {}
+
+BlockPool::~BlockPool() {
+    for (auto slab : _slabs) {
+        ::operator delete(slab);
+    }
+}
+
+void* BlockPool::allocate() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_free_list == nullptr) {
+        AddSlab(_blocks_per_slab);
+    }
+    auto block = _free_list;
+    _free_list = block->next;
+    _size++;
+    return block;
+}
+
+void BlockPool::deallocate(void* block) noexcept {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto free_block = static_cast<FreeBlock*>(block);
+    free_block->next = _free_list;
+    _free_list = free_block;
+    _size--;
+}
+
+void BlockPool::reserve(std::size_t count) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (count > _capacity) {
+        AddSlab(count - _capacity);
+    }
+}
+
+std::size_t BlockPool::capacity() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _capacity;
+}
+
+std::size_t BlockPool::size() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _size;
+}
+
+void BlockPool::AddSlab(std::size_t block_count) {
+    auto slab = static_cast<char*>(::operator new(block_count * _block_size));
+    _slabs.push_back(slab);
+    // Threads the new blocks onto the free list in address order, so consecutive allocations are laid out contiguously
+    for (std::size_t index = block_count; index-- > 0;) {
+        auto block = reinterpret_cast<FreeBlock*>(slab + index * _block_size);
+        block->next = _free_list;
+        _free_list = block;
+    }
+    _capacity += block_count;
+}
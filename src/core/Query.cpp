@@ -0,0 +1,34 @@
+#include <algorithm>
+#include "ember/core/Query.hpp"
+#include "ember/core/GameObject.hpp"
+
+using namespace ember;
+
+constexpr std::uint32_t QueryIndex::npos;
+
+void QueryIndex::Insert(const GameObject& object) {
+    const auto object_id = object.object_id();
+    if (_rows_by_slot.size() <= object_id.index) {
+        _rows_by_slot.resize(object_id.index + 1, npos);
+    }
+    _rows_by_slot[object_id.index] = static_cast<std::uint32_t>(_object_ids.size());
+    _object_ids.push_back(object_id);
+    _required.forEach([this, &object](BehaviourTypeId type_id) { _behaviours.push_back(object.BehaviourAt(type_id)); });
+}
+
+void QueryIndex::Remove(SlotHandle object_id) {
+    if (!Contains(object_id)) {
+        return;
+    }
+    const std::size_t row = _rows_by_slot[object_id.index];
+    const std::size_t last_row = _object_ids.size() - 1;
+    if (row != last_row) {
+        const auto moved = _object_ids[last_row];
+        _object_ids[row] = moved;
+        std::copy(_behaviours.begin() + last_row * _stride, _behaviours.begin() + (last_row + 1) * _stride, _behaviours.begin() + row * _stride);
+        _rows_by_slot[moved.index] = static_cast<std::uint32_t>(row);
+    }
+    _object_ids.pop_back();
+    _behaviours.resize(last_row * _stride);
+    _rows_by_slot[object_id.index] = npos;
+}
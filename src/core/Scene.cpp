@@ -1,4 +1,7 @@
 #include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <cmath>
 #include "ember/core/Scene.hpp"
 
 using namespace ember;
@@ -6,14 +9,17 @@ using namespace ember;
 Scene::Scene() {};
 
 Scene::~Scene() {
-    auto game_object_deletion_copy = _objects_in_scene;
-	for (auto& gameObject : game_object_deletion_copy) {
-		gameObject.second->onEnd();
+    BeginPhase();
+	for (auto& game_object : _objects_in_scene) {
+        if (!game_object._pending_addition) {
+		    game_object.onEnd();
+        }
 	}
     auto system_deletion_copy = _systems_in_scene;
 	for (auto& sys : system_deletion_copy) {
 		sys.second->onEnd();
 	}
+    EndPhase();
 };
 
 Scene::Scene(Scene&& other) {
@@ -29,103 +35,1088 @@ void Scene::RunUpdateCycle(double deltaT) {
     if (!_hasStarted) {
         onStart();
     }
-    onPreUpdate();
+    if (DrainEventIngress() != 0) {
+        flushEvents();
+    }
+    if (_fixed_timestep <= 0) {
+        RunCycleStep(deltaT);
+        return;
+    }
+    _time_accumulator += deltaT;
+    for (std::size_t step = 0; step < _max_fixed_steps && _time_accumulator >= _fixed_timestep; step++) {
+        RunCycleStep(_fixed_timestep);
+        _time_accumulator -= _fixed_timestep;
+    }
+    if (_time_accumulator >= _fixed_timestep) {
+        _time_accumulator = std::fmod(_time_accumulator, _fixed_timestep);
+    }
+}
+
+void Scene::RunCycleStep(double deltaT) {
+    FlushEventsAt(FlushBeforePreUpdate);
+    onPreUpdate(deltaT);
+    FlushEventsAt(FlushAfterPreUpdate);
     onUpdate(deltaT);
+    FlushEventsAt(FlushAfterUpdate);
     onPostUpdate();
+    FlushEventsAt(FlushAfterPostUpdate);
+}
+
+void Scene::flushEvents() {
+    if (_flushing_events) {
+        return;
+    }
+    _flushing_events = true;
+    // Every queue is taken at once, so events queued by handlers (or by other threads, which may also add queues) wait for the next flush,
+    // whatever their type. The queues themselves are never destroyed, so they are delivered outside of the lock
+    {
+        std::lock_guard<std::mutex> lock(_event_queues_mutex);
+        for (auto& queue : _event_queues) {
+            if (queue && queue->TakeQueued()) {
+                _flushing_queues.push_back(queue.get());
+            }
+        }
+    }
+    BeginPhase();
+    for (auto queue : _flushing_queues) {
+        queue->Deliver(*this);
+    }
+    EndPhase();
+    _flushing_queues.clear();
+    _flushing_events = false;
+}
+
+void Scene::setEventIngressCapacity(std::size_t capacity) {
+    DrainEventIngress();
+    _event_ingress.reset(new EventIngress(capacity));
+}
+
+std::size_t Scene::DrainEventIngress() {
+    std::lock_guard<std::mutex> lock(_event_queues_mutex);
+    return _event_ingress->Drain(this);
+}
+
+void Scene::setFixedTimestep(double step, std::size_t max_steps_per_call) {
+    _fixed_timestep = step > 0 ? step : 0;
+    _max_fixed_steps = max_steps_per_call;
+    _time_accumulator = 0;
 }
 
 void Scene::onStart() {
 	_hasStarted = true;
-    std::map<GameObject::id, std::shared_ptr<GameObject>> delayed_deletion_copy(_objects_in_scene);
-	for (auto& game_object : delayed_deletion_copy) {
-		game_object.second->onStart();
+    BeginPhase();
+	for (auto& game_object : _objects_in_scene) {
+        if (!game_object._pending_addition) {
+		    game_object.onStart();
+        }
 	}
     for (auto& system_in_scene : _systems_in_scene) {
         system_in_scene.second->onStart();
     }
+    EndPhase();
 }
 
-void Scene::onPreUpdate() {
-    std::map<GameObject::id, std::shared_ptr<GameObject>> delayed_deletion_copy(_objects_in_scene);
-	for (auto& game_object : delayed_deletion_copy) {
-		game_object.second->onPreUpdate();
-        if(game_object.second->_behaviours_changed) {
-            FilterGameObjectThroughAllSystems(game_object.second);
-        }
-	}
+void Scene::onPreUpdate(double deltaT) {
+    BeginPhase();
     for (auto& system_in_scene : _systems_in_scene) {
-        system_in_scene.second->onPreUpdate();
+        auto& system = *system_in_scene.second;
+        if (system._tick_period > 0 && !system._tick_clock_started) {
+            // Golden ratio sequence, spreading any number of systems evenly over their periods
+            const double stagger = std::fmod(0.6180339887498949 * static_cast<double>(++_tick_stagger_sequence), 1.0);
+            system.AdvanceTickClock(deltaT, stagger);
+        } else {
+            system.AdvanceTickClock(deltaT, 0);
+        }
     }
+    DispatchPhase(BehaviourHooks::PreUpdate, [](Behaviour& behaviour) { behaviour.onPreUpdate(); });
+    for (const auto& object_id : _objects_to_refilter) {
+        auto game_object = FindGameObject(object_id);
+        if (game_object != nullptr && game_object->_behaviours_changed) {
+            FilterGameObjectThroughAllSystems(*game_object);
+        }
+    }
+    _objects_to_refilter.clear();
+    RunSystems([](BaseSystem& system) { system.onPreUpdate(); });
+    EndPhase();
 }
 
 void Scene::onUpdate(double deltaT) {
-    std::map<GameObject::id, std::shared_ptr<GameObject>> delayed_deletion_copy(_objects_in_scene);
-	for (auto& game_object : delayed_deletion_copy) {
-		game_object.second->onUpdate(deltaT);
-	}
+    BeginPhase();
+    DispatchPhase(BehaviourHooks::Update, [deltaT](Behaviour& behaviour) { behaviour.onUpdate(deltaT); });
+    RunSystems([](BaseSystem& system) { system.onUpdate(system._tick_delta); });
+    EndPhase();
+}
+
+void Scene::onPostUpdate() {
+    BeginPhase();
+    DispatchPhase(BehaviourHooks::PostUpdate, [](Behaviour& behaviour) { behaviour.onPostUpdate(); });
+    // Serializations cached so far belong to the cycle that ends here. Behaviours that don't report their changes are polled now, while the
+    // state they changed during the cycle is still there to be seen; changes reported are found by each object when its caches are next used
+    PollSerializationCaches();
+    _serialization_cycle.store(_serialization_cycle.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    RunSystems([](BaseSystem& system) { system.onPostUpdate(); });
+    EndPhase();
+}
+
+void Scene::RegisterBehaviourHooks(Behaviour& behaviour) {
+    if (behaviour._hooks_registered) {
+        return;
+    }
+    for (std::size_t phase = 0; phase < BehaviourHooks::PhaseCount; phase++) {
+        if ((behaviour._overridden_hooks & (1u << phase)) != 0) {
+            auto& dispatch = DispatchListFor(phase, behaviour);
+            behaviour._dispatch_positions[phase] = dispatch.size();
+            dispatch.push_back(&behaviour);
+        }
+    }
+    behaviour._hooks_registered = true;
+}
+
+void Scene::UnregisterBehaviourHooks(Behaviour& behaviour) {
+    if (!behaviour._hooks_registered) {
+        return;
+    }
+    for (std::size_t phase = 0; phase < BehaviourHooks::PhaseCount; phase++) {
+        if ((behaviour._overridden_hooks & (1u << phase)) != 0) {
+            auto& dispatch = DispatchListFor(phase, behaviour);
+            auto position = behaviour._dispatch_positions[phase];
+            dispatch[position] = dispatch.back();
+            dispatch[position]->_dispatch_positions[phase] = position;
+            dispatch.pop_back();
+        }
+    }
+    behaviour._hooks_registered = false;
+}
+
+void Scene::IndexBehaviour(Behaviour& behaviour) {
+    if (behaviour._indexed_by_type) {
+        return;
+    }
+    if (_behaviours_by_type.size() <= behaviour._type_id) {
+        _behaviours_by_type.resize(behaviour._type_id + 1);
+    }
+    auto& behaviours = _behaviours_by_type[behaviour._type_id];
+    behaviour._type_list_position = behaviours.size();
+    behaviours.push_back(&behaviour);
+    _behaviour_types_in_scene.set(behaviour._type_id);
+    behaviour._indexed_by_type = true;
+    MarkSnapshotDirty(behaviour, Behaviour::snapshot_unsent);
+}
+
+void Scene::PollSerializationCaches() {
+    // Taken out of the list, so behaviours serializing other objects from IsSerializationDirty may list them meanwhile
+    std::vector<GameObject::id> objects;
+    {
+        std::lock_guard<std::mutex> lock(_polled_caches_mutex);
+        objects.swap(_objects_with_polled_caches);
+    }
+    std::size_t kept = 0;
+    for (auto object_id : objects) {
+        auto game_object = FindGameObject(object_id);
+        if (game_object == nullptr) {
+            continue;
+        }
+        if (game_object->PollSerializationCaches()) {
+            objects[kept++] = object_id;
+        } else {
+            game_object->_polled_caches_listed.store(false, std::memory_order_relaxed);
+        }
+    }
+    std::lock_guard<std::mutex> lock(_polled_caches_mutex);
+    _objects_with_polled_caches.insert(_objects_with_polled_caches.end(), objects.begin(), objects.begin() + kept);
+}
+
+void Scene::MarkSnapshotDirty(Behaviour& behaviour, unsigned char changes) {
+    if (!_snapshot_tracking) {
+        return;
+    }
+    behaviour._snapshot_state.fetch_or(changes, std::memory_order_relaxed);
+    auto& object = *behaviour._gameObjectOwner;
+    if (!object._snapshot_listed.exchange(true, std::memory_order_acq_rel)) {
+        std::lock_guard<std::mutex> lock(_snapshot_dirty_mutex);
+        _snapshot_dirty_objects.push_back(object._id);
+    }
+}
+
+std::size_t Scene::writeSnapshot(std::vector<std::uint8_t>& buffer, SnapshotMode mode) {
+    SnapshotWriter writer(buffer);
+    writer.BeginSnapshot(mode);
+    if (mode == SnapshotMode::Full || !_snapshot_tracking) {
+        // The first delta sends everything, and starts tracking changes from there
+        const bool first_delta = mode == SnapshotMode::Delta;
+        if (SerializesInParallel(_objects_in_scene.size())) {
+            const auto object_ids = _objects_in_scene.handles();
+            const auto chunk_count = (object_ids.size() + _serialization_grain_size - 1) / _serialization_grain_size;
+            std::vector<std::vector<std::uint8_t>> chunk_buffers(chunk_count);
+            std::vector<std::unique_ptr<SnapshotWriter>> chunk_writers(chunk_count);
+            _thread_pool->ParallelFor(0, object_ids.size(), _serialization_grain_size, [&](std::size_t begin, std::size_t end) {
+                const auto chunk = begin / _serialization_grain_size;
+                chunk_writers[chunk].reset(new SnapshotWriter(chunk_buffers[chunk]));
+                auto& chunk_writer = *chunk_writers[chunk];
+                chunk_writer.BeginSnapshot(mode);
+                for (std::size_t position = begin; position < end; position++) {
+                    auto& game_object = *_objects_in_scene.get(object_ids[position]);
+                    if (!game_object._pending_addition) {
+                        WriteSnapshotFrames(chunk_writer, game_object, false, first_delta);
+                    }
+                }
+            });
+            for (const auto& chunk_writer : chunk_writers) {
+                writer.AppendFrames(*chunk_writer);
+            }
+        } else {
+            for (auto& game_object : _objects_in_scene) {
+                if (!game_object._pending_addition) {
+                    WriteSnapshotFrames(writer, game_object, false, first_delta);
+                }
+            }
+        }
+        _snapshot_tracking = _snapshot_tracking || first_delta;
+        writer.EndSnapshot();
+        return writer._frame_count;
+    }
+    for (auto object_id : _snapshot_tombstones) {
+        writer.BeginFrame();
+        writer.EndFrame(object_id, 0, SnapshotFrameKind::Tombstone);
+    }
+    _snapshot_tombstones.clear();
+    std::vector<GameObject::id> dirty_objects;
+    dirty_objects.swap(_snapshot_dirty_objects);
+    // Sorted, so the frames don't depend on the order in which threads flagged changes
+    std::sort(dirty_objects.begin(), dirty_objects.end(), [](const GameObject::id& lhs, const GameObject::id& rhs) { return lhs.index < rhs.index; });
+    for (auto object_id : dirty_objects) {
+        auto game_object = FindGameObject(object_id);
+        if (game_object == nullptr) {
+            continue;
+        }
+        if (game_object->_pending_addition) {
+            // Its behaviours are reported once it joins the scene
+            _snapshot_dirty_objects.push_back(object_id);
+            continue;
+        }
+        game_object->_snapshot_listed.store(false, std::memory_order_relaxed);
+        WriteSnapshotFrames(writer, *game_object, true, true);
+    }
+    writer.EndSnapshot();
+    return writer._frame_count;
+}
+
+void Scene::WriteSnapshotFrames(SnapshotWriter& writer, GameObject& object, bool changes_only, bool consume_changes) {
+    using Serializable = addons::SerializableInto<SnapshotWriter>;
+    SubtypeRegistry& registry = SubtypeRegistry::For<Serializable>();
+    object.ResolveSubtypes(registry);
+    registry.Derived(object._behaviour_mask).forEach([&](BehaviourTypeId type_id) {
+        auto behaviour = object.BehaviourAt(type_id);
+        // Looked up first, so a type without a tag throws before its changes are consumed
+        auto tag = SnapshotTags::Of(type_id);
+        auto changes = consume_changes ? behaviour->_snapshot_state.exchange(0, std::memory_order_relaxed) : 0;
+        if (changes_only && changes == 0) {
+            return;
+        }
+        auto& serializable = *registry.Cast<Serializable>(behaviour, type_id);
+        writer.BeginFrame();
+        if (changes_only && (changes & Behaviour::snapshot_unsent) == 0 && serializable.PartialSerializeInto(writer)) {
+            writer.EndFrame(object._id, tag, SnapshotFrameKind::Partial);
+        } else {
+            writer.RewindFrame();
+            serializable.SerializeInto(writer);
+            writer.EndFrame(object._id, tag, SnapshotFrameKind::Full);
+        }
+        object._snapshot_sent = object._snapshot_sent || consume_changes;
+    });
+}
+
+void Scene::UnindexBehaviour(Behaviour& behaviour) {
+    if (!behaviour._indexed_by_type) {
+        return;
+    }
+    auto& behaviours = _behaviours_by_type[behaviour._type_id];
+    auto position = behaviour._type_list_position;
+    behaviours[position] = behaviours.back();
+    behaviours[position]->_type_list_position = position;
+    behaviours.pop_back();
+    if (behaviours.empty()) {
+        _behaviour_types_in_scene.reset(behaviour._type_id);
+    }
+    behaviour._indexed_by_type = false;
+}
+
+void Scene::ResolveTypesInScene(SubtypeRegistry& registry) {
+    _behaviour_types_in_scene.forEach([this, &registry](BehaviourTypeId type_id) {
+        registry.Resolve(type_id, _behaviours_by_type[type_id].front());
+    });
+}
+
+const std::vector<void*>& Scene::SystemListeners(const std::type_info& listener_type, void* (*cast)(BaseSystem&)) {
+    // Entries are never erased while systems run, so the list returned stays valid once the lock is released
+    std::lock_guard<std::mutex> lock(_system_listeners_mutex);
+    auto cached = _system_listeners.find(std::type_index(listener_type));
+    if (cached != _system_listeners.end()) {
+        return cached->second;
+    }
+    auto& listeners = _system_listeners[std::type_index(listener_type)];
     for (auto& system_in_scene : _systems_in_scene) {
-        system_in_scene.second->onUpdate(deltaT);
+        if (auto listener = cast(*system_in_scene.second)) {
+            listeners.push_back(listener);
+        }
     }
+    return listeners;
 }
 
-void Scene::onPostUpdate() {
-    std::map<GameObject::id, std::shared_ptr<GameObject>> delayed_deletion_copy(_objects_in_scene);
-	for (auto& game_object : delayed_deletion_copy) {
-		game_object.second->onPostUpdate();
-	}
+std::vector<Behaviour*>& Scene::DispatchListFor(std::size_t phase, const Behaviour& behaviour) {
+    if (!_type_batched_updates) {
+        return _phase_dispatch[phase];
+    }
+    auto& typed_dispatch = _typed_phase_dispatch[phase];
+    if (typed_dispatch.size() <= behaviour._type_id) {
+        typed_dispatch.resize(behaviour._type_id + 1);
+    }
+    auto& dispatch = typed_dispatch[behaviour._type_id];
+    if (!_types_used.test(behaviour._type_id)) {
+        _types_used.set(behaviour._type_id);
+        _type_first_use_order.push_back(behaviour._type_id);
+        _type_dispatch_order_dirty = true;
+    }
+    return dispatch;
+}
+
+void Scene::setTypeBatchedUpdates(bool enabled) {
+    if (enabled == _type_batched_updates) {
+        return;
+    }
+    // Moves every registered behaviour to the dispatch lists of the new mode
+    std::vector<Behaviour*> registered;
+    for (auto& game_object : _objects_in_scene) {
+        for (auto& entry : game_object._behaviours) {
+            if (entry.behaviour->_hooks_registered) {
+                UnregisterBehaviourHooks(*entry.behaviour);
+                registered.push_back(entry.behaviour.get());
+            }
+        }
+    }
+    _type_batched_updates = enabled;
+    for (auto behaviour : registered) {
+        RegisterBehaviourHooks(*behaviour);
+    }
+}
+
+void Scene::RebuildTypeDispatchOrder() {
+    _type_dispatch_order.clear();
+    for (auto type_id : _configured_type_order) {
+        if (std::find(_type_dispatch_order.begin(), _type_dispatch_order.end(), type_id) == _type_dispatch_order.end()) {
+            _type_dispatch_order.push_back(type_id);
+        }
+    }
+    for (auto type_id : _type_first_use_order) {
+        if (std::find(_configured_type_order.begin(), _configured_type_order.end(), type_id) == _configured_type_order.end()) {
+            _type_dispatch_order.push_back(type_id);
+        }
+    }
+    _type_dispatch_order_dirty = false;
+}
+
+void Scene::setWorkerCount(std::size_t worker_count) {
+    _thread_pool.reset(worker_count != 0 ? new ThreadPool(worker_count) : nullptr);
+}
+
+void Scene::RunSystems(const std::function<void(BaseSystem&)>& phase) {
+    if (!_thread_pool) {
+        for (auto& system_in_scene : _systems_in_scene) {
+            if (system_in_scene.second->_ticking) {
+                phase(*system_in_scene.second);
+            }
+        }
+        return;
+    }
+    if (_system_schedule_dirty) {
+        RebuildSystemSchedule();
+    }
+    for (const auto& stage : _system_stages) {
+        if (_stage_changes.size() < stage.size()) {
+            _stage_changes.resize(stage.size());
+        }
+        std::vector<ThreadPool::Task> tasks;
+        tasks.reserve(stage.size());
+        for (std::size_t position = 0; position < stage.size(); position++) {
+            auto system = stage[position];
+            if (system->_ticking) {
+                auto& changes = _stage_changes[position];
+                tasks.push_back([this, &phase, system, &changes]() {
+                    DeferredChangesScope scope(*this, changes);
+                    phase(*system);
+                });
+            }
+        }
+        _thread_pool->Run(std::move(tasks));
+        for (std::size_t position = 0; position < stage.size(); position++) {
+            CommitDeferredChanges(_stage_changes[position]);
+        }
+    }
+}
+
+void Scene::ParallelFor(std::size_t begin, std::size_t end, std::size_t grain_size, const std::function<void(std::size_t, std::size_t)>& fun) {
+    if (grain_size == 0) {
+        grain_size = 1;
+    }
+    std::vector<DeferredChanges> chunk_changes((end - begin + grain_size - 1) / grain_size);
+    _thread_pool->ParallelFor(begin, end, grain_size, [this, begin, grain_size, &fun, &chunk_changes](std::size_t chunk_begin, std::size_t chunk_end) {
+        DeferredChangesScope scope(*this, chunk_changes[(chunk_begin - begin) / grain_size]);
+        fun(chunk_begin, chunk_end);
+    });
+    for (auto& changes : chunk_changes) {
+        MergeDeferredChanges(changes);
+    }
+}
+
+thread_local Scene* Scene::_task_scene = nullptr;
+thread_local Scene::DeferredChanges* Scene::_task_changes = nullptr;
+
+Scene::DeferredChangesScope::DeferredChangesScope(Scene& scene, DeferredChanges& changes)
+    : previous_scene(_task_scene), previous_changes(_task_changes) {
+    _task_scene = &scene;
+    _task_changes = &changes;
+}
+
+Scene::DeferredChangesScope::~DeferredChangesScope() {
+    _task_scene = previous_scene;
+    _task_changes = previous_changes;
+}
+
+Scene::DeferredChanges* Scene::TaskChanges() const {
+    // A task may change another scene than the one running it, which takes the changes as usual
+    return _task_scene == this ? _task_changes : nullptr;
+}
+
+void Scene::MergeDeferredChanges(DeferredChanges& changes) {
+    auto into = TaskChanges();
+    if (into == nullptr) {
+        CommitDeferredChanges(changes);
+        return;
+    }
+    // Buffered objects are held by pointer, so moving them across buffers keeps the commands referring to them valid
+    std::move(changes.commands.begin(), changes.commands.end(), std::back_inserter(into->commands));
+    std::move(changes.objects.begin(), changes.objects.end(), std::back_inserter(into->objects));
+    std::move(changes.batches.begin(), changes.batches.end(), std::back_inserter(into->batches));
+    changes.commands.clear();
+    changes.objects.clear();
+    changes.batches.clear();
+}
+
+void Scene::CommitDeferredChanges(DeferredChanges& changes) {
+    for (auto& command : changes.commands) {
+        if (command.type == StructuralCommand::Type::AddGameObject && command.buffered_object != nullptr) {
+            // An object destroyed before it was ever placed just goes away with the buffer
+            if (command.buffered_object->_pending_removal) {
+                continue;
+            }
+            command.object_id = PlaceBufferedObject(*command.buffered_object);
+            command.buffered_object = nullptr;
+        } else if (command.type == StructuralCommand::Type::AddGameObjectBatch) {
+            std::vector<GameObject::id> ids;
+            ids.reserve(changes.batches.front().size());
+            for (auto game_object : changes.batches.front()) {
+                if (!game_object->_pending_removal) {
+                    ids.push_back(PlaceBufferedObject(*game_object));
+                }
+            }
+            changes.batches.pop_front();
+            _pending_batches.push_back(std::move(ids));
+        }
+        _structural_commands.push_back(std::move(command));
+    }
+    changes.commands.clear();
+    changes.objects.clear();
+    changes.batches.clear();
+}
+
+GameObject::id Scene::PlaceBufferedObject(GameObject& object) {
+    auto id_for_gameobject = _objects_in_scene.emplace(std::move(object));
+    auto& new_object = *_objects_in_scene.get(id_for_gameobject);
+    new_object._id = id_for_gameobject;
+    new_object._parent_scene = this;
+    new_object._pending_addition = true;
+    new_object._sleeping = object._sleeping;
+    new_object._next_behaviour_index = object._next_behaviour_index;
+    new_object._behaviours_changed = object._behaviours_changed;
+    new_object._changed_behaviour_types = object._changed_behaviour_types;
+    for (auto& entry : new_object._behaviours) {
+        entry.behaviour->_id.first = id_for_gameobject;
+    }
+    return id_for_gameobject;
+}
+
+void Scene::RebuildSystemSchedule() {
+    // Each system goes in the stage after the last one holding a system it conflicts with, walking the systems in their serial order,
+    // so conflicting systems always run in that same order.
+    _system_stages.clear();
+    std::vector<std::pair<BaseSystem*, std::size_t>> scheduled;
     for (auto& system_in_scene : _systems_in_scene) {
-        system_in_scene.second->onPostUpdate();
+        auto system = system_in_scene.second.get();
+        std::size_t stage = 0;
+        for (const auto& previous : scheduled) {
+            if (previous.second >= stage && previous.first->access().ConflictsWith(system->access())) {
+                stage = previous.second + 1;
+            }
+        }
+        scheduled.emplace_back(system, stage);
+        if (_system_stages.size() <= stage) {
+            _system_stages.resize(stage + 1);
+        }
+        _system_stages[stage].push_back(system);
+    }
+    _system_schedule_dirty = false;
+}
+
+void Scene::BeginPhase() {
+    _phase_depth.fetch_add(1, std::memory_order_relaxed);
+}
+
+void Scene::EndPhase() {
+    if (_phase_depth.load(std::memory_order_relaxed) != 1) {
+        _phase_depth.fetch_sub(1, std::memory_order_relaxed);
+        return;
+    }
+    // Sync point. The phase is kept open while the commands are applied, so any change they cause in turn (a destroyed object
+    // removing others from its onEnd, for example) is queued, and applied on the next pass.
+    while (!_structural_commands.empty()) {
+        // Swapping keeps the capacity of both buffers, so steady state spawning and despawning doesn't reallocate them
+        _applying_commands.swap(_structural_commands);
+        for (auto& command : _applying_commands) {
+            switch (command.type) {
+            case StructuralCommand::Type::AddGameObject:
+                if (auto game_object = FindGameObject(command.object_id)) {
+                    game_object->_pending_addition = false;
+                    for (auto& entry : game_object->_behaviours) {
+                        IndexBehaviour(*entry.behaviour);
+                    }
+                    if (!game_object->_sleeping) {
+                        for (auto& entry : game_object->_behaviours) {
+                            RegisterBehaviourHooks(*entry.behaviour);
+                        }
+                    }
+                    UpdateArchetype(*game_object);
+                    if (!game_object->_sleeping) {
+                        AddToQueries(*game_object);
+                    }
+                    if (game_object->_behaviours_changed) {
+                        _objects_to_refilter.push_back(game_object->_id);
+                    }
+                    if (_hasStarted) {
+                        game_object->onStart();
+                    }
+                }
+                break;
+            case StructuralCommand::Type::AddGameObjectBatch:
+                AddPendingBatch(_pending_batches.front());
+                _pending_batches.pop_front();
+                break;
+            case StructuralCommand::Type::RemoveGameObject:
+                DestroyGameObject(command.object_id);
+                break;
+            case StructuralCommand::Type::SleepGameObject:
+            case StructuralCommand::Type::WakeGameObject:
+                if (auto game_object = FindGameObject(command.object_id)) {
+                    if (command.type == StructuralCommand::Type::WakeGameObject) {
+                        game_object->_pending_wake.store(false, std::memory_order_relaxed);
+                    }
+                    ApplyGameObjectSleeping(*game_object, command.type == StructuralCommand::Type::SleepGameObject);
+                }
+                break;
+            case StructuralCommand::Type::AttachBehaviour:
+                if (auto game_object = FindGameObject(command.object_id)) {
+                    game_object->AttachBehaviour(command.behaviour_type, std::move(command.behaviour));
+                }
+                break;
+            }
+        }
+        _applying_commands.clear();
     }
+    _phase_depth.fetch_sub(1, std::memory_order_relaxed);
 }
 
 GameObject& Scene::addGameObject() {
-    auto id_for_gameobject = _next_game_object_index++;
-    _objects_in_scene[id_for_gameobject] = std::make_shared<GameObject>();
-    auto& new_object = _objects_in_scene[id_for_gameobject];
-    new_object->_id = id_for_gameobject;
-    new_object->_parent_scene = this;
+    if (auto changes = TaskChanges()) {
+        changes->objects.emplace_back(new GameObject());
+        auto& new_object = *changes->objects.back();
+        new_object._parent_scene = this;
+        new_object._pending_addition = true;
+        changes->commands.push_back(StructuralCommand{StructuralCommand::Type::AddGameObject, GameObject::id(), 0, nullptr, &new_object});
+        return new_object;
+    }
+    if (IsDeferringChanges()) {
+        std::lock_guard<std::mutex> lock(_structural_commands_mutex);
+        auto id_for_gameobject = _objects_in_scene.emplace();
+        auto& new_object = *_objects_in_scene.get(id_for_gameobject);
+        new_object._id = id_for_gameobject;
+        new_object._parent_scene = this;
+        new_object._pending_addition = true;
+        _structural_commands.push_back(StructuralCommand{StructuralCommand::Type::AddGameObject, id_for_gameobject});
+        return new_object;
+    }
+    auto id_for_gameobject = _objects_in_scene.emplace();
+    auto& new_object = *_objects_in_scene.get(id_for_gameobject);
+    new_object._id = id_for_gameobject;
+    new_object._parent_scene = this;
 	if (_hasStarted) {
-		new_object->onStart();
+		new_object.onStart();
 	}
-	return *new_object;
+	return new_object;
+}
+
+std::vector<GameObject*> Scene::CreatePendingBatch(std::size_t count) {
+    std::vector<GameObject*> objects;
+    objects.reserve(count);
+    if (auto changes = TaskChanges()) {
+        for (std::size_t index = 0; index < count; index++) {
+            changes->objects.emplace_back(new GameObject());
+            auto& new_object = *changes->objects.back();
+            new_object._parent_scene = this;
+            new_object._pending_addition = true;
+            objects.push_back(&new_object);
+        }
+        return objects;
+    }
+    std::unique_lock<std::mutex> lock(_structural_commands_mutex, std::defer_lock);
+    if (IsDeferringChanges()) {
+        lock.lock();
+    }
+    _objects_in_scene.reserve(_objects_in_scene.size() + count);
+    for (std::size_t index = 0; index < count; index++) {
+        auto id_for_gameobject = _objects_in_scene.emplace();
+        auto& new_object = *_objects_in_scene.get(id_for_gameobject);
+        new_object._id = id_for_gameobject;
+        new_object._parent_scene = this;
+        new_object._pending_addition = true;
+        objects.push_back(&new_object);
+    }
+    return objects;
+}
+
+std::vector<GameObject::id> Scene::CommitPendingBatch(const std::vector<GameObject*>& objects) {
+    std::vector<GameObject::id> ids;
+    ids.reserve(objects.size());
+    for (auto game_object : objects) {
+        ids.push_back(game_object->_id);
+    }
+    if (auto changes = TaskChanges()) {
+        changes->batches.push_back(objects);
+        changes->commands.push_back(StructuralCommand{StructuralCommand::Type::AddGameObjectBatch, GameObject::id()});
+    } else if (IsDeferringChanges()) {
+        std::lock_guard<std::mutex> lock(_structural_commands_mutex);
+        _pending_batches.push_back(ids);
+        _structural_commands.push_back(StructuralCommand{StructuralCommand::Type::AddGameObjectBatch, GameObject::id()});
+    } else {
+        AddPendingBatch(ids);
+    }
+    return ids;
+}
+
+void Scene::AddPendingBatch(const std::vector<GameObject::id>& ids) {
+    // Systems with exact filters only depend on the object's set of behaviour types, which is usually the same across the batch
+    const GameObject* reference_object = nullptr;
+    std::vector<BaseSystem*> exact_systems_passing;
+    std::vector<BaseSystem*> inexact_systems;
+    for (const auto& id : ids) {
+        auto game_object = FindGameObject(id);
+        if (game_object == nullptr) {
+            continue;
+        }
+        game_object->_pending_addition = false;
+        for (auto& entry : game_object->_behaviours) {
+            IndexBehaviour(*entry.behaviour);
+        }
+        if (!game_object->_sleeping) {
+            for (auto& entry : game_object->_behaviours) {
+                RegisterBehaviourHooks(*entry.behaviour);
+            }
+        }
+        UpdateArchetype(*game_object);
+        if (!game_object->_sleeping) {
+            AddToQueries(*game_object);
+        }
+        if (reference_object == nullptr) {
+            reference_object = game_object;
+            for (auto& system_in_scene : _systems_in_scene) {
+                auto system = system_in_scene.second.get();
+                if (!system->_filter_masks.exact) {
+                    inexact_systems.push_back(system);
+                } else if (system->PassesFilter(*game_object)) {
+                    exact_systems_passing.push_back(system);
+                }
+            }
+        }
+        if (game_object->_behaviour_mask != reference_object->_behaviour_mask || game_object->_sleeping) {
+            FilterGameObjectThroughAllSystems(*game_object);
+            continue;
+        }
+        for (auto system : exact_systems_passing) {
+            system->onGameObjectAdded(*game_object);
+        }
+        for (auto system : inexact_systems) {
+            system->FilterGameObject(*game_object);
+        }
+        game_object->_filtered_through_systems = true;
+        game_object->_changed_behaviour_types = BehaviourMask();
+        game_object->_behaviours_changed = false;
+    }
+    if (_hasStarted) {
+        for (const auto& id : ids) {
+            if (auto game_object = FindGameObject(id)) {
+                game_object->onStart();
+            }
+        }
+    }
 }
 
 bool Scene::hasGameObject(GameObject::id index) const {
-    return _objects_in_scene.count(index) == 1;
+    auto game_object = _objects_in_scene.get(index);
+    return game_object != nullptr && !game_object->_pending_removal;
 }
 
 GameObject& Scene::refGameObject(GameObject::id index) throw(std::invalid_argument) {
-    if (_objects_in_scene.count(index) == 0) {
-        throw std::invalid_argument("Scene::refGameObject - No GameObject with id " + std::to_string(index) + " exists in scene");
+    if (!hasGameObject(index)) {
+        throw std::invalid_argument("Scene::refGameObject - No GameObject with id " + std::to_string(index.index) + ":" +
+            std::to_string(index.generation) + " exists in scene");
     }
-    return *_objects_in_scene[index];
+    return *_objects_in_scene.get(index);
 }
 
 void Scene::removeGameObject(GameObject::id index) {
-    _objects_in_scene.erase(index);
+    if (!hasGameObject(index)) {
+        return;
+    }
+    if (auto changes = TaskChanges()) {
+        // Each system removing the object queues the removal, so the first to be applied doesn't depend on which thread got here first
+        _objects_in_scene.get(index)->_pending_removal = true;
+        changes->commands.push_back(StructuralCommand{StructuralCommand::Type::RemoveGameObject, index});
+    } else if (IsDeferringChanges()) {
+        std::lock_guard<std::mutex> lock(_structural_commands_mutex);
+        if (_objects_in_scene.get(index)->_pending_removal.exchange(true)) {
+            return;
+        }
+        _structural_commands.push_back(StructuralCommand{StructuralCommand::Type::RemoveGameObject, index});
+    } else {
+        DestroyGameObject(index);
+    }
+}
+
+void Scene::SetGameObjectSleeping(GameObject::id index, bool sleeping) {
+    if (auto changes = TaskChanges()) {
+        auto game_object = FindGameObject(index);
+        if (game_object != nullptr && !NoteQueuedSleeping(*game_object, sleeping)) {
+            return;
+        }
+        changes->commands.push_back(StructuralCommand{
+            sleeping ? StructuralCommand::Type::SleepGameObject : StructuralCommand::Type::WakeGameObject, index});
+        return;
+    }
+    if (IsDeferringChanges()) {
+        std::lock_guard<std::mutex> lock(_structural_commands_mutex);
+        auto game_object = FindGameObject(index);
+        if (game_object != nullptr && game_object->_pending_addition) {
+            // Not taking part in the cycle yet, it joins the scene already asleep (or awake)
+            game_object->_sleeping = sleeping;
+            return;
+        }
+        if (game_object != nullptr && !NoteQueuedSleeping(*game_object, sleeping)) {
+            return;
+        }
+        _structural_commands.push_back(StructuralCommand{
+            sleeping ? StructuralCommand::Type::SleepGameObject : StructuralCommand::Type::WakeGameObject, index});
+    } else if (auto game_object = FindGameObject(index)) {
+        ApplyGameObjectSleeping(*game_object, sleeping);
+    }
 }
 
-void Scene::FilterGameObjectThroughAllSystems(const std::shared_ptr<GameObject>& object) {
+bool Scene::NoteQueuedSleeping(GameObject& object, bool sleeping) {
+    if (sleeping) {
+        // A wake queued before this sleep doesn't stand for a later one
+        object._pending_wake.store(false, std::memory_order_relaxed);
+        return true;
+    }
+    return !object._pending_wake.exchange(true, std::memory_order_relaxed);
+}
+
+void Scene::ApplyGameObjectSleeping(GameObject& object, bool sleeping) {
+    if (object._sleeping == sleeping) {
+        return;
+    }
+    object._sleeping = sleeping;
+    if (object._pending_addition) {
+        return;
+    }
+    if (object._archetype != nullptr) {
+        object._archetype->SetAsleep(object._archetype_row, sleeping);
+    }
+    for (auto& entry : object._behaviours) {
+        if (sleeping) {
+            UnregisterBehaviourHooks(*entry.behaviour);
+        } else {
+            RegisterBehaviourHooks(*entry.behaviour);
+        }
+    }
+    if (sleeping) {
+        RemoveFromQueries(object);
+    } else {
+        AddToQueries(object);
+    }
     for (auto& system_in_scene : _systems_in_scene) {
-        system_in_scene.second->FilterGameObject(object);
+        auto& system = *system_in_scene.second;
+        if (sleeping) {
+            if (system._managed_objects.erase(object._id)) {
+                system._sleeping_objects.insert(object._id);
+            }
+        } else if (system._sleeping_objects.erase(object._id)) {
+            system._managed_objects.insert(object._id);
+        }
+    }
+}
+
+void Scene::DestroyGameObject(GameObject::id index) {
+    if (auto game_object = FindGameObject(index)) {
+        if (game_object->_sleeping) {
+            for (auto& system_in_scene : _systems_in_scene) {
+                system_in_scene.second->_sleeping_objects.erase(index);
+            }
+        }
+        for (auto& entry : game_object->_behaviours) {
+            UnregisterBehaviourHooks(*entry.behaviour);
+            UnindexBehaviour(*entry.behaviour);
+        }
+        RemoveFromArchetype(*game_object);
+        RemoveFromQueries(*game_object);
+        if (game_object->_snapshot_sent) {
+            _snapshot_tombstones.push_back(index);
+        }
+        _objects_in_scene.erase(index);
+    }
+}
+
+void Scene::reserveGameObjects(std::size_t count) {
+    _objects_in_scene.reserve(count);
+}
+
+void Scene::setArchetypeStorage(bool enabled) {
+    if (enabled == _archetype_storage_enabled) {
+        return;
+    }
+    _archetype_storage_enabled = enabled;
+    _archetypes.clear();
+    for (auto& game_object : _objects_in_scene) {
+        game_object._archetype = nullptr;
+        UpdateArchetype(game_object);
+    }
+}
+
+ArchetypeStats Scene::archetypeStats() const {
+    ArchetypeStats stats;
+    stats.archetypes = _archetypes.size();
+    for (const auto& keypair : _archetypes) {
+        stats.chunks += keypair.second->chunks().size();
+        stats.objects += keypair.second->size();
+    }
+    stats.moves = _archetype_moves;
+    return stats;
+}
+
+QueryIndex& Scene::IndexFor(const BehaviourMask& required) {
+    // Queries may be made from systems running in parallel, while others add objects to the storage walked below
+    std::lock_guard<std::mutex> lock(_query_indices_mutex);
+    auto& index = _query_indices[required];
+    if (!index) {
+        std::unique_lock<std::mutex> structural_lock(_structural_commands_mutex, std::defer_lock);
+        if (IsDeferringChanges()) {
+            structural_lock.lock();
+        }
+        index.reset(new QueryIndex(required));
+        required.forEach([this, &index](BehaviourTypeId type_id) {
+            if (_query_indices_by_behaviour_type.size() <= type_id) {
+                _query_indices_by_behaviour_type.resize(type_id + 1);
+            }
+            _query_indices_by_behaviour_type[type_id].push_back(index.get());
+        });
+        for (auto& game_object : _objects_in_scene) {
+            if (!game_object._pending_addition && !game_object._sleeping && game_object._behaviour_mask.contains(required)) {
+                index->Insert(game_object);
+            }
+        }
+    }
+    return *index;
+}
+
+void Scene::AddToQueries(GameObject& object) {
+    for (auto& keypair : _query_indices) {
+        auto& index = *keypair.second;
+        if (object._behaviour_mask.contains(index.required()) && !index.Contains(object._id)) {
+            index.Insert(object);
+        }
+    }
+}
+
+void Scene::AddToQueries(GameObject& object, BehaviourTypeId type_id) {
+    if (type_id >= _query_indices_by_behaviour_type.size()) {
+        return;
+    }
+    // The object didn't hold the type before, so it can't be in any of these indices yet
+    for (auto index : _query_indices_by_behaviour_type[type_id]) {
+        if (object._behaviour_mask.contains(index->required())) {
+            index->Insert(object);
+        }
     }
-    object->_behaviours_changed = false;
+}
+
+void Scene::RemoveFromQueries(GameObject& object) {
+    for (auto& keypair : _query_indices) {
+        if (object._behaviour_mask.contains(keypair.second->required())) {
+            keypair.second->Remove(object._id);
+        }
+    }
+}
+
+void Scene::UpdateArchetype(GameObject& object) {
+    if (!_archetype_storage_enabled || object._pending_addition) {
+        return;
+    }
+    if (object._archetype != nullptr) {
+        _archetype_moves++;
+        RemoveFromArchetype(object);
+    }
+    const auto& signature = object._behaviour_mask;
+    if (signature.none()) {
+        return;
+    }
+    auto& archetype = _archetypes[signature];
+    if (!archetype) {
+        archetype.reset(new Archetype(signature));
+    }
+    object._archetype = archetype.get();
+    object._archetype_row = archetype->Insert(object);
+}
+
+void Scene::RemoveFromArchetype(GameObject& object) {
+    if (object._archetype == nullptr) {
+        return;
+    }
+    auto moved = object._archetype->Remove(object._archetype_row);
+    if (!moved.is_null()) {
+        FindGameObject(moved)->_archetype_row = object._archetype_row;
+    }
+    object._archetype = nullptr;
+}
+
+void Scene::QueueBehaviourAttachment(GameObject::id object_id, BehaviourTypeId type_id, std::shared_ptr<Behaviour> behaviour) {
+    if (auto changes = TaskChanges()) {
+        changes->commands.push_back(StructuralCommand{StructuralCommand::Type::AttachBehaviour, object_id, type_id, std::move(behaviour)});
+        return;
+    }
+    std::lock_guard<std::mutex> lock(_structural_commands_mutex);
+    _structural_commands.push_back(StructuralCommand{StructuralCommand::Type::AttachBehaviour, object_id, type_id, std::move(behaviour)});
+}
+
+GameObject* Scene::FindGameObject(GameObject::id index) {
+    return _objects_in_scene.get(index);
+}
+
+void Scene::IndexSystemFilter(BaseSystem& system) {
+    const auto& masks = system._filter_masks;
+    BehaviourMask relevant = masks.required;
+    masks.excluded.forEach([&relevant](BehaviourTypeId type_id) { relevant.set(type_id); });
+    // Exact filters depending on no type at all never change their outcome, but are kept with the inexact ones for simplicity
+    if (!masks.exact || relevant.none()) {
+        _systems_filtering_every_change.push_back(&system);
+        return;
+    }
+    relevant.forEach([this, &system](BehaviourTypeId type_id) {
+        if (_systems_by_behaviour_type.size() <= type_id) {
+            _systems_by_behaviour_type.resize(type_id + 1);
+        }
+        _systems_by_behaviour_type[type_id].push_back(&system);
+    });
+}
+
+void Scene::FilterGameObjectThroughAllSystems(GameObject& object) {
+    if (!object._filtered_through_systems) {
+        for (auto& system_in_scene : _systems_in_scene) {
+            system_in_scene.second->FilterGameObject(object);
+        }
+        object._filtered_through_systems = true;
+    } else {
+        const std::size_t filter_pass = ++_filter_pass;
+        auto filter_once = [&object, filter_pass](BaseSystem* system) {
+            if (system->_filter_pass != filter_pass) {
+                system->_filter_pass = filter_pass;
+                system->FilterGameObject(object);
+            }
+        };
+        object._changed_behaviour_types.forEach([this, &filter_once](BehaviourTypeId type_id) {
+            if (type_id < _systems_by_behaviour_type.size()) {
+                for (auto system : _systems_by_behaviour_type[type_id]) {
+                    filter_once(system);
+                }
+            }
+        });
+        for (auto system : _systems_filtering_every_change) {
+            filter_once(system);
+        }
+    }
+    object._changed_behaviour_types = BehaviourMask();
+    object._behaviours_changed = false;
 }
 
 void Scene::FilterAllGameObjectsThroughSystem(const std::shared_ptr<BaseSystem>& system_to_filter) {
-    for (const auto& game_object : _objects_in_scene) {
-        system_to_filter->FilterGameObject(game_object.second);
-        game_object.second->_behaviours_changed = false;
+    // Objects with pending changes keep them, as the other systems still have to be tested against those
+    for (auto& game_object : _objects_in_scene) {
+        system_to_filter->FilterGameObject(game_object);
     }
 }
 
 void Scene::Swap(Scene&& other) {
-    _next_game_object_index = other._next_game_object_index;
 	_hasStarted = other._hasStarted;
+    std::swap(_fixed_timestep, other._fixed_timestep);
+    std::swap(_max_fixed_steps, other._max_fixed_steps);
+    std::swap(_time_accumulator, other._time_accumulator);
+    std::swap(_tick_stagger_sequence, other._tick_stagger_sequence);
     _objects_in_scene.swap(other._objects_in_scene);
+    _objects_to_refilter.swap(other._objects_to_refilter);
+    _query_indices.swap(other._query_indices);
+    _behaviours_by_type.swap(other._behaviours_by_type);
+    std::swap(_behaviour_types_in_scene, other._behaviour_types_in_scene);
+    _query_indices_by_behaviour_type.swap(other._query_indices_by_behaviour_type);
     _systems_in_scene.swap(other._systems_in_scene);
+    _system_listeners.swap(other._system_listeners);
+    _event_queues.swap(other._event_queues);
+    std::swap(_event_flush_points, other._event_flush_points);
+    _event_ingress.swap(other._event_ingress);
+    const auto serialization_cycle = _serialization_cycle.load(std::memory_order_relaxed);
+    _serialization_cycle.store(other._serialization_cycle.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    other._serialization_cycle.store(serialization_cycle, std::memory_order_relaxed);
+    std::swap(_serialization_grain_size, other._serialization_grain_size);
+    std::swap(_snapshot_tracking, other._snapshot_tracking);
+    _snapshot_dirty_objects.swap(other._snapshot_dirty_objects);
+    _snapshot_tombstones.swap(other._snapshot_tombstones);
+    _objects_with_polled_caches.swap(other._objects_with_polled_caches);
+    _change_journal.swap(other._change_journal);
+    _thread_pool.swap(other._thread_pool);
+    for (std::size_t phase = 0; phase < BehaviourHooks::PhaseCount; phase++) {
+        _phase_dispatch[phase].swap(other._phase_dispatch[phase]);
+        _typed_phase_dispatch[phase].swap(other._typed_phase_dispatch[phase]);
+    }
+    std::swap(_type_batched_updates, other._type_batched_updates);
+    _configured_type_order.swap(other._configured_type_order);
+    _type_first_use_order.swap(other._type_first_use_order);
+    std::swap(_types_used, other._types_used);
+    _type_dispatch_order.swap(other._type_dispatch_order);
+    std::swap(_type_dispatch_order_dirty, other._type_dispatch_order_dirty);
+    std::swap(_archetype_storage_enabled, other._archetype_storage_enabled);
+    _archetypes.swap(other._archetypes);
+    std::swap(_archetype_moves, other._archetype_moves);
+    _systems_by_behaviour_type.swap(other._systems_by_behaviour_type);
+    _systems_filtering_every_change.swap(other._systems_filtering_every_change);
+    std::swap(_filter_pass, other._filter_pass);
+    _system_schedule_dirty = true;
+    other._system_schedule_dirty = true;
     for (auto& object_in_scene : _objects_in_scene) {
-        object_in_scene.second->_parent_scene = this;
+        object_in_scene._parent_scene = this;
     }
     for (auto& system_in_scene : _systems_in_scene) {
         system_in_scene.second->_parent_scene = this;
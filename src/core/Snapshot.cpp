@@ -0,0 +1,138 @@
+#include <map>
+#include "ember/core/Snapshot.hpp"
+
+using namespace ember;
+
+constexpr std::size_t SnapshotWriter::header_size;
+constexpr std::size_t SnapshotWriter::frame_header_size;
+
+namespace {
+const std::uint8_t format_version = 2;
+
+// Tags by behaviour type id (holding a tag one past the actual one, 0 for types without a tag), and the type given each tag
+std::vector<std::uint32_t>& TagsByTypeId() {
+    static std::vector<std::uint32_t> tags;
+    return tags;
+}
+
+std::map<std::uint16_t, BehaviourTypeId>& TypeIdsByTag() {
+    static std::map<std::uint16_t, BehaviourTypeId> type_ids;
+    return type_ids;
+}
+
+inline void StoreLittleEndian(std::uint8_t* destination, std::uint32_t value, std::size_t bytes) {
+    for (std::size_t byte = 0; byte < bytes; byte++) {
+        destination[byte] = static_cast<std::uint8_t>(value >> (8 * byte));
+    }
+}
+
+inline std::uint32_t LoadLittleEndian(const std::uint8_t* source, std::size_t bytes) {
+    std::uint32_t value = 0;
+    for (std::size_t byte = 0; byte < bytes; byte++) {
+        value |= static_cast<std::uint32_t>(source[byte]) << (8 * byte);
+    }
+    return value;
+}
+}
+
+void SnapshotTags::Register(BehaviourTypeId type_id, std::uint16_t tag) {
+    auto& tags = TagsByTypeId();
+    auto& type_ids = TypeIdsByTag();
+    if (tags.size() <= type_id) {
+        tags.resize(type_id + 1, 0);
+    }
+    auto registered = type_ids.find(tag);
+    if (registered != type_ids.end() && registered->second != type_id) {
+        throw std::invalid_argument("SnapshotTags::Register - The tag was given to another behaviour type");
+    }
+    if (tags[type_id] != 0 && tags[type_id] != static_cast<std::uint32_t>(tag) + 1) {
+        throw std::invalid_argument("SnapshotTags::Register - The behaviour type already has another tag");
+    }
+    tags[type_id] = static_cast<std::uint32_t>(tag) + 1;
+    type_ids[tag] = type_id;
+}
+
+std::uint16_t SnapshotTags::Of(BehaviourTypeId type_id) {
+    const auto& tags = TagsByTypeId();
+    if (type_id >= tags.size() || tags[type_id] == 0) {
+        throw std::invalid_argument("SnapshotTags::Of - The behaviour type has no snapshot tag");
+    }
+    return static_cast<std::uint16_t>(tags[type_id] - 1);
+}
+
+void SnapshotWriter::write(const void* data, std::size_t size) {
+    const auto bytes = static_cast<const std::uint8_t*>(data);
+    _buffer.insert(_buffer.end(), bytes, bytes + size);
+}
+
+void SnapshotWriter::BeginSnapshot(SnapshotMode mode) {
+    _buffer.clear();
+    _buffer.resize(header_size);
+    _buffer[0] = 'E';
+    _buffer[1] = 'S';
+    _buffer[2] = format_version;
+    _buffer[3] = static_cast<std::uint8_t>(mode);
+    _frame_count = 0;
+}
+
+void SnapshotWriter::BeginFrame() {
+    _frame_begin = _buffer.size();
+    _buffer.resize(_frame_begin + frame_header_size);
+}
+
+void SnapshotWriter::RewindFrame() {
+    _buffer.resize(_frame_begin + frame_header_size);
+}
+
+void SnapshotWriter::EndFrame(SlotHandle object_id, std::uint16_t tag, SnapshotFrameKind kind) {
+    auto header = &_buffer[_frame_begin];
+    StoreLittleEndian(header, object_id.index, 4);
+    StoreLittleEndian(header + 4, object_id.generation, 4);
+    StoreLittleEndian(header + 8, tag, 2);
+    header[10] = static_cast<std::uint8_t>(kind);
+    StoreLittleEndian(header + 11, static_cast<std::uint32_t>(payload_size()), 4);
+    _frame_count++;
+}
+
+void SnapshotWriter::EndSnapshot() {
+    StoreLittleEndian(&_buffer[4], _frame_count, 4);
+}
+
+void SnapshotWriter::AppendFrames(const SnapshotWriter& other) {
+    _buffer.insert(_buffer.end(), other._buffer.begin() + header_size, other._buffer.end());
+    _frame_count += other._frame_count;
+}
+
+SnapshotReader::SnapshotReader(const std::uint8_t* data, std::size_t size) : _data(data), _size(size) {
+    if (size < SnapshotWriter::header_size || data[0] != 'E' || data[1] != 'S' || data[2] != format_version || data[3] > 1) {
+        throw std::invalid_argument("SnapshotReader - The buffer doesn't hold a snapshot");
+    }
+    _mode = static_cast<SnapshotMode>(data[3]);
+    _frame_count = LoadLittleEndian(data + 4, 4);
+}
+
+bool SnapshotReader::next(SnapshotFrame& frame) {
+    if (_frames_read == _frame_count) {
+        return false;
+    }
+    if (_size - _position < SnapshotWriter::frame_header_size) {
+        throw std::invalid_argument("SnapshotReader::next - The snapshot ends within a frame header");
+    }
+    const auto header = _data + _position;
+    const std::size_t payload_size = LoadLittleEndian(header + 11, 4);
+    if (_size - _position - SnapshotWriter::frame_header_size < payload_size) {
+        throw std::invalid_argument("SnapshotReader::next - The snapshot ends within a frame payload");
+    }
+    if (header[10] > static_cast<std::uint8_t>(SnapshotFrameKind::Tombstone)) {
+        throw std::invalid_argument("SnapshotReader::next - The frame is of an unknown kind");
+    }
+    frame.object_id.index = LoadLittleEndian(header, 4);
+    frame.object_id.generation = LoadLittleEndian(header + 4, 4);
+    frame.tag = static_cast<std::uint16_t>(LoadLittleEndian(header + 8, 2));
+    frame.kind = static_cast<SnapshotFrameKind>(header[10]);
+    frame.payload = header + SnapshotWriter::frame_header_size;
+    frame.payload_size = payload_size;
+    _position += SnapshotWriter::frame_header_size + payload_size;
+    _frames_read++;
+    return true;
+}
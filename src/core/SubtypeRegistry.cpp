@@ -0,0 +1,46 @@
+#include "ember/core/SubtypeRegistry.hpp"
+#include "ember/core/Behaviour.hpp"
+
+using namespace ember;
+
+constexpr std::size_t SubtypeRegistry::word_count;
+
+bool SubtypeRegistry::IsResolved(const BehaviourMask& types) const {
+    for (std::size_t word = 0; word < word_count; word++) {
+        if ((types._words[word] & ~_resolved[word].load(std::memory_order_acquire)) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SubtypeRegistry::Resolve(BehaviourTypeId type_id, Behaviour* instance) {
+    std::lock_guard<std::mutex> lock(_resolve_mutex);
+    const std::size_t word = type_id / 64;
+    const std::uint64_t bit = std::uint64_t(1) << (type_id % 64);
+    if ((_resolved[word].load(std::memory_order_relaxed) & bit) != 0) {
+        return;
+    }
+    if (auto base = _cast(instance)) {
+        _offsets[type_id].store(static_cast<char*>(base) - reinterpret_cast<char*>(instance), std::memory_order_relaxed);
+        _derived[word].fetch_or(bit, std::memory_order_release);
+    }
+    _resolved[word].fetch_or(bit, std::memory_order_release);
+}
+
+BehaviourMask SubtypeRegistry::Derived(const BehaviourMask& types) const {
+    BehaviourMask derived;
+    for (std::size_t word = 0; word < word_count; word++) {
+        derived._words[word] = types._words[word] & _derived[word].load(std::memory_order_acquire);
+    }
+    return derived;
+}
+
+bool SubtypeRegistry::AnyDerived(const BehaviourMask& types) const {
+    for (std::size_t word = 0; word < word_count; word++) {
+        if ((types._words[word] & _derived[word].load(std::memory_order_acquire)) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include "ember/core/ThreadPool.hpp"
+
+using namespace ember;
+
+namespace {
+// Identifies the pool, and the queue within it, owned by the current thread
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local std::size_t current_queue = 0;
+}
+
+ThreadPool::ThreadPool(std::size_t worker_count) {
+    for (std::size_t index = 0; index <= worker_count; index++) {
+        _queues.emplace_back(new WorkQueue());
+    }
+    for (std::size_t index = 0; index < worker_count; index++) {
+        _workers.emplace_back(&ThreadPool::WorkerLoop, this, index);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(_sleep_mutex);
+        _stopping = true;
+    }
+    _wake_workers.notify_all();
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::Run(std::vector<Task> tasks) {
+    if (_workers.empty() || tasks.size() == 1) {
+        for (auto& task : tasks) {
+            task();
+        }
+        return;
+    }
+
+    Batch batch;
+    batch.remaining = tasks.size();
+    const bool is_worker = current_pool == this;
+    const std::size_t own_queue = is_worker ? current_queue : _workers.size();
+    for (std::size_t index = 0; index < tasks.size(); index++) {
+        // Workers keep their jobs, to be stolen by idle workers, outside threads spread them evenly
+        auto& queue = *_queues[is_worker ? own_queue : index % _workers.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(Job{std::move(tasks[index]), &batch});
+    }
+    {
+        std::lock_guard<std::mutex> lock(_sleep_mutex);
+        _queued_jobs += tasks.size();
+    }
+    _wake_workers.notify_all();
+
+    while (batch.remaining.load(std::memory_order_acquire) != 0) {
+        if (!TryRunOne(own_queue)) {
+            std::this_thread::yield();
+        }
+    }
+    if (batch.exception) {
+        std::rethrow_exception(batch.exception);
+    }
+}
+
+void ThreadPool::ParallelFor(std::size_t begin, std::size_t end, std::size_t grain_size,
+    const std::function<void(std::size_t, std::size_t)>& fun) {
+    if (grain_size == 0) {
+        grain_size = 1;
+    }
+    std::vector<Task> chunks;
+    chunks.reserve((end - begin + grain_size - 1) / grain_size);
+    for (std::size_t chunk_begin = begin; chunk_begin < end; chunk_begin += grain_size) {
+        std::size_t chunk_end = std::min(end, chunk_begin + grain_size);
+        chunks.push_back([&fun, chunk_begin, chunk_end]() { fun(chunk_begin, chunk_end); });
+    }
+    Run(std::move(chunks));
+}
+
+void ThreadPool::WorkerLoop(std::size_t worker_index) {
+    current_pool = this;
+    current_queue = worker_index;
+    while (true) {
+        if (TryRunOne(worker_index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(_sleep_mutex);
+        _wake_workers.wait(lock, [this]() { return _stopping || _queued_jobs != 0; });
+        if (_stopping) {
+            return;
+        }
+    }
+}
+
+bool ThreadPool::TryRunOne(std::size_t own_queue) {
+    Job job{nullptr, nullptr};
+    bool found = false;
+    {
+        auto& queue = *_queues[own_queue];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            found = true;
+        }
+    }
+    for (std::size_t offset = 1; !found && offset < _queues.size(); offset++) {
+        auto& queue = *_queues[(own_queue + offset) % _queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            found = true;
+        }
+    }
+    if (!found) {
+        return false;
+    }
+    _queued_jobs--;
+
+    try {
+        job.task();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(job.batch->exception_mutex);
+        if (!job.batch->exception) {
+            job.batch->exception = std::current_exception();
+        }
+    }
+    job.batch->remaining.fetch_sub(1, std::memory_order_release);
+    return true;
+}
@@ -43,19 +43,17 @@ std::vector<std::weak_ptr<BaseCollider>> CollisionEngine::GetCollisionShortlistF
     }
 }
 
-void CollisionEngine::onGameObjectAdded(const std::weak_ptr<GameObject>& weak_obj) {
-    if (auto shared_obj = weak_obj.lock()) {
-        for (auto& base_collider : shared_obj->getBehaviours<BaseCollider>()) {
-            auto shared_collider = base_collider.lock();
-            shared_collider->_is_collision_engine_attached = true;
-            if (shared_collider->IsStatic()) {
-                _static_colliders.push_back(shared_collider);
-            } else {
-                _movable_colliders.push_back(shared_collider);
-            }
-            if (_spatial_partitioner) {
-                _spatial_partitioner->PartitionCollider(shared_collider);
-            }
+void CollisionEngine::onGameObjectAdded(GameObject& object) {
+    for (auto& base_collider : object.getBehaviours<BaseCollider>()) {
+        auto shared_collider = base_collider.lock();
+        shared_collider->_is_collision_engine_attached = true;
+        if (shared_collider->IsStatic()) {
+            _static_colliders.push_back(shared_collider);
+        } else {
+            _movable_colliders.push_back(shared_collider);
+        }
+        if (_spatial_partitioner) {
+            _spatial_partitioner->PartitionCollider(shared_collider);
         }
     }
 }
@@ -0,0 +1,4 @@
+#include "core/Scene.hpp"
+#include "core/GameObject.hpp"
+#include "core/System.hpp"
+#include "core/Behaviour.hpp"
@@ -0,0 +1,42 @@
+#ifndef Ember_DirtyValue_hpp
+#define Ember_DirtyValue_hpp
+
+#include <utility>
+
+#include "ember/core/Behaviour.hpp"
+
+namespace ember {
+namespace addons {
+
+/// Dirty Value is an utility class that can be used in Behaviours to encapsulate class variables of any type.
+/// The encapsulated value will always be accessible through get(), however a dirty flag will be set to true, every time the
+/// value is set(). This flag can be checked, as well as cleaned, if the behaviour acknowledges the change in value.
+/// A DirtyValue bound to the behaviour holding it (constructed with the behaviour as first argument) also reports every set() to it, through
+/// Behaviour::MarkSerializationDirty. A behaviour whose serialized state is all held in bound values can declare so (see
+/// Behaviour::setReportsSerializationChanges), keeping its serializations cached for as long as none of those values change.
+template <typename ParamType>
+class DirtyValue {
+public:
+    DirtyValue(ParamType data) : _is_dirty(true), _data(std::move(data)) {}
+    DirtyValue(Behaviour& owner, ParamType data) : _owner(&owner), _is_dirty(true), _data(std::move(data)) {}
+
+    const ParamType& get() const { return _data; }
+    void set(ParamType new_data) {
+        std::swap(_data, new_data);
+        _is_dirty = true;
+        if (_owner != nullptr) {
+            _owner->MarkSerializationDirty();
+        }
+    }
+
+    bool is_dirty() const { return _is_dirty; }
+    void clean() { _is_dirty = false; }
+
+private:
+    Behaviour* _owner = nullptr;
+    bool _is_dirty;
+    ParamType _data;
+};
+
+}}
+#endif
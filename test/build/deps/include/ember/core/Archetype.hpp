@@ -0,0 +1,80 @@
+#ifndef Ember_Archetype_hpp
+#define Ember_Archetype_hpp
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "ember/core/SlotMap.hpp"
+#include "ember/core/BehaviourType.hpp"
+
+namespace ember {
+
+class Behaviour;
+class GameObject;
+
+/// An Archetype groups every object of a scene that holds exactly the same set of behaviour types (its signature).
+/// Objects in an archetype are laid out in fixed size chunks, in structure of arrays form: each chunk holds the ids of its objects, and one
+/// contiguous column per behaviour type in the signature, with the objects' behaviours of that type, in the same order.
+/// Archetypes are only maintained by the Scene when archetype storage is enabled (see Scene::setArchetypeStorage).
+class Archetype {
+    friend class Scene;
+public:
+    static constexpr std::size_t chunk_capacity = 128;
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    struct Chunk {
+        explicit Chunk(std::size_t column_count) : columns(new Behaviour*[column_count * chunk_capacity]) {}
+
+        inline Behaviour* const* column(std::size_t column_index) const { return columns.get() + column_index * chunk_capacity; }
+        inline Behaviour** column(std::size_t column_index) { return columns.get() + column_index * chunk_capacity; }
+
+        std::size_t size = 0;
+        SlotHandle object_ids[chunk_capacity];
+        // Set for the rows of sleeping objects, which stay in their archetype
+        bool asleep[chunk_capacity];
+        std::unique_ptr<Behaviour*[]> columns;
+    };
+
+    explicit Archetype(const BehaviourMask& signature) : _signature(signature), _column_count(signature.count()) {}
+    Archetype(const Archetype& other) = delete;
+    Archetype& operator=(const Archetype& other) = delete;
+
+public:
+    /// The behaviour types held by every object in the archetype. Columns are laid out in increasing type id order.
+    inline const BehaviourMask& signature() const { return _signature; }
+
+    /// Index of the column holding the behaviours of the type with the provided id, or npos if the type is not part of the signature.
+    inline std::size_t ColumnOf(BehaviourTypeId type_id) const { return _signature.test(type_id) ? _signature.rank(type_id) : npos; }
+
+    /// Number of objects in the archetype.
+    inline std::size_t size() const { return _size; }
+    inline const std::vector<std::unique_ptr<Chunk>>& chunks() const { return _chunks; }
+
+private:
+    // Appends the object to the last chunk, returning the row it was placed at.
+    std::size_t Insert(GameObject& object);
+
+    // Removes the object at 'row', moving the last object of the archetype into its place. Returns the id of the moved object, or a
+    // null id if the removed object was the last one.
+    SlotHandle Remove(std::size_t row);
+
+    inline void SetAsleep(std::size_t row, bool asleep) { _chunks[row / chunk_capacity]->asleep[row % chunk_capacity] = asleep; }
+
+    BehaviourMask _signature;
+    std::size_t _column_count;
+    std::vector<std::unique_ptr<Chunk>> _chunks;
+    std::size_t _size = 0;
+};
+
+/// Counters describing the state of a Scene archetype storage, and the work done to maintain it.
+struct ArchetypeStats {
+    std::size_t archetypes = 0;
+    std::size_t chunks = 0;
+    std::size_t objects = 0;
+    /// Number of times an object moved from one archetype to another, as its behaviours changed
+    std::size_t moves = 0;
+};
+
+}
+#endif
@@ -0,0 +1,23 @@
+#ifndef Ember_Prefab_hpp
+#define Ember_Prefab_hpp
+
+#include <cstddef>
+
+namespace ember {
+
+class GameObject;
+
+/// A Prefab is a compile time list of behaviour types, used by Scene::spawnBatch to build many objects holding the same behaviours.
+/// Each spawned object gets a default constructed behaviour of every listed type; per object setup is done through the batch initializer.
+template <typename... BehaviourTypes>
+struct Prefab {
+    static constexpr std::size_t behaviour_count = sizeof...(BehaviourTypes);
+};
+
+/// Initializer used by Scene::spawnBatch when none is provided, leaving the behaviours as constructed.
+struct NoPrefabInit {
+    inline void operator()(GameObject&, std::size_t) const {}
+};
+
+}
+#endif
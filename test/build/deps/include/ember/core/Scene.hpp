@@ -0,0 +1,258 @@
+#ifndef Scene_hpp
+#define Scene_hpp
+
+#include <map>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <initializer_list>
+
+#include "SlotMap.hpp"
+#include "Archetype.hpp"
+#include "Query.hpp"
+#include "EventQueue.hpp"
+#include "EventIngress.hpp"
+#include "Snapshot.hpp"
+#include "ChangeJournal.hpp"
+#include "PoolAllocator.hpp"
+#include "BehaviourHooks.hpp"
+#include "Prefab.hpp"
+#include "ThreadPool.hpp"
+#include "GameObject.hpp"
+#include "System.hpp"
+#include <typeindex>
+
+namespace ember {
+
+/// The Scene is a quintissential part of ember. It's withing a scene that everything that the framework has to offer, happens.
+/// A Scene, at it's basic level, is a container of both objects and systems, and is responsible for updating both at the right times, in the right order.
+class Scene {
+    friend class GameObject;
+    friend class Behaviour;
+    friend class JournalEntry;
+    friend class BaseSystem;
+    template <typename EventType> friend class EventQueue;
+public:
+	Scene();
+    ~Scene();
+	Scene(const Scene& other) = delete;
+	Scene(Scene&& other);
+	Scene& operator=(const Scene& other) = delete;
+	Scene& operator=(Scene&& other);
+
+public:
+    inline bool hasStarted() { return _hasStarted; }
+
+    /// Runs an update cycle within the Scene, updating all Behaviours and Systems.
+    /// On the first call to RunUpdateCycle, onStart will be called, before the regular cycle calls, on all Behaviours and Systems.
+    /// A regular update cycle consists of calling 'onPreUpdate' --> 'onUpdate' --> 'onPostUpdate' on all Behaviours and Systems.
+    /// Each callback will always be called first on the Behaviours, and then on the Systems. Behaviours are only called for the hooks their type
+    /// overrides (see BehaviourHooks.hpp), in no particular order.
+    /// With a fixed timestep set, deltaT is accumulated instead, and the cycle runs once per whole step accumulated, always with a deltaT of one step.
+    void RunUpdateCycle(double deltaT);
+
+    /// Sets a fixed timestep, in milliseconds, for RunUpdateCycle. Each call then runs as many update cycles of 'step' as the accumulated time
+    /// allows, up to 'max_steps_per_call': if the scene falls further behind, the excess time is dropped, rather than spiralling into ever longer
+    /// calls. Time left over, less than a step, is carried over to the next call (see interpolationAlpha).
+    /// A step of 0 (the default) disables the fixed timestep, running exactly one cycle per call.
+    void setFixedTimestep(double step, std::size_t max_steps_per_call = 5);
+    inline double fixedTimestep() const { return _fixed_timestep; }
+
+    /// Fraction of a fixed step accumulated but not yet run, in [0, 1). Useful to interpolate rendering between the last two steps.
+    inline double interpolationAlpha() const { return _fixed_timestep > 0 ? _time_accumulator / _fixed_timestep : 0; }
+
+    /// Enables or disables type batched updates. With type batched updates, each update phase calls its hook on every behaviour of one type
+    /// before moving on to the next type, keeping the same code hot across consecutive calls, instead of mixing types in no particular order.
+    /// Types are visited in the order set by setBehaviourTypeOrder, followed by every other type, in the order they were first used.
+    /// Disabled by default. Must not be called during an update cycle.
+    void setTypeBatchedUpdates(bool enabled);
+    inline bool typeBatchedUpdates() const { return _type_batched_updates; }
+
+    /// Sets which behaviour types are updated first, and in which order, when type batched updates are enabled.
+    template <typename... BehaviourTypes>
+    void setBehaviourTypeOrder();
+
+    /// Sets how many worker threads the scene uses to run its Systems. With no workers (the default) every system runs on the thread
+    /// calling RunUpdateCycle, one at a time, in a fixed order.
+    /// With workers, the systems' update callbacks run in stages: systems whose declared access (see SystemAccess.hpp) doesn't conflict share a stage,
+    /// and run at the same time across the workers (and the calling thread). Conflicting systems keep their relative order, in separate stages.
+    /// Structural changes (adding or removing objects, attaching behaviours) are safe to make from systems running in parallel, as they are deferred until
+    /// the end of the phase. So are BroadcastEvent and GameObject::CastEvent, though their listeners then run on the system's thread, possibly
+    /// alongside listeners called from other systems. Must not be called during an update cycle.
+    void setWorkerCount(std::size_t worker_count);
+    inline std::size_t workerCount() const { return _thread_pool ? _thread_pool->worker_count() : 0; }
+
+    /// Pre-allocates storage for at least 'count' objects in the scene (including the ones it already holds).
+    /// The storage of removed objects is reused by new ones, so a scene that has reserved its peak object count spawns and despawns without heap allocations.
+    void reserveGameObjects(std::size_t count);
+
+    /// Pre-allocates pooled storage for at least 'count' behaviours of type BehaviourSubType (including the ones alive).
+    /// Behaviour pools are per type, and shared by every scene.
+    template <typename BehaviourSubType>
+    void reserveBehaviours(std::size_t count);
+
+    /// Enables or disables archetype storage. With archetype storage enabled, the scene keeps every object grouped with the objects holding exactly
+    /// the same set of behaviour types, in chunks laid out by behaviour type (see Archetype.hpp), which lets forEachWithBehaviours stream through
+    /// matching objects linearly, instead of visiting every object in the scene. The cost is paid when an object's set of behaviours changes:
+    /// it moves from one archetype to another. Disabled by default. Must not be called during an update cycle.
+    void setArchetypeStorage(bool enabled);
+    inline bool archetypeStorage() const { return _archetype_storage_enabled; }
+    ArchetypeStats archetypeStats() const;
+
+    /// Calls 'fun(BehaviourTypes&...)' for every object in the scene that holds behaviours of all the listed types (non-polymorphic, exact types only).
+    /// With archetype storage enabled, only the archetypes holding every type are visited, one chunk column at a time; otherwise every object in the
+    /// scene is checked. 'fun' must not add or remove objects or behaviours outside of an update phase.
+    template <typename... BehaviourTypes, typename Function>
+    void forEachWithBehaviours(Function&& fun);
+
+    /// Returns a view over every awake object in the scene holding behaviours of all the listed types (non-polymorphic, exact types only),
+    /// yielding a tuple of references to them per object (see Query.hpp). The first query for a set of types indexes the scene once; from then on
+    /// the scene keeps the index up to date as objects and behaviours come and go, eagerly, so the view is always current, and iterating it
+    /// costs nothing but the matching objects. Queries for the same types in a different order, or differently cv-qualified, share the same index.
+    /// Safe to call from systems running in parallel (see setWorkerCount): creating and looking up indices takes a lock, so systems querying
+    /// on every update should rather keep their Query, which stays valid for as long as the scene exists.
+    template <typename... BehaviourTypes>
+    Query<BehaviourTypes...> query();
+
+    /// Writes a binary snapshot of the scene into 'buffer', replacing its contents but keeping its capacity, and returns the number of frames
+    /// written. Each frame holds one behaviour of one object, serialized through addons::SerializableInto<SnapshotWriter>, or the removal of
+    /// an object (see Snapshot.hpp for the format, and SnapshotReader to read it back).
+    /// A Full snapshot serializes every such behaviour in the scene, in storage order. A Delta snapshot only visits the objects in the scene's
+    /// dirty set: behaviours added since the previous delta are serialized in full, behaviours flagged through Behaviour::MarkSerializationDirty
+    /// are serialized partially (or in full, if PartialSerializeInto serializes nothing), and objects removed are reported as
+    /// tombstones (see SnapshotFrameKind), so the cost is that of the changes rather than of the scene. Deltas consume the dirty set; full snapshots leave it untouched.
+    /// Changes are only tracked from the first delta on, which is therefore written in full.
+    /// Throws std::invalid_argument if a behaviour to serialize has no snapshot tag (see SnapshotTags).
+    /// With a serialization grain size set, full snapshots (and the first delta) are written across the scene's worker threads (see
+    /// setSerializationGrainSize), into a buffer per chunk of objects, concatenated in storage order: the output is the same as when serial.
+    /// Must be called from the thread running the scene, outside of its update cycle.
+    std::size_t writeSnapshot(std::vector<std::uint8_t>& buffer, SnapshotMode mode);
+
+    /// Serializes every object in the scene into SerializableType, through GameObject::SerializeShared, so cached serializations are reused
+    /// and serializations made here are cached for later readers. Returns the id and serialization of every object at least one of whose
+    /// behaviours serializes into SerializableType, in increasing storage slot order, whatever the number of threads.
+    /// With a serialization grain size set, objects are serialized across the scene's worker threads, each chunk into its own range of the
+    /// output; the behaviours' SerializeInto must then be safe to call on different objects at once.
+    /// Must be called from the thread running the scene, outside of its update cycle.
+    template <typename SerializableType>
+    std::vector<std::pair<GameObject::id, std::shared_ptr<const SerializableType>>> serializeGameObjects();
+
+    /// Sets the number of objects per chunk when serializing the whole scene (see serializeGameObjects and writeSnapshot), chunks being
+    /// processed across the scene's worker threads. A grain size of 0 (the default) keeps serialization serial, as does a scene without workers.
+    inline void setSerializationGrainSize(std::size_t grain_size) { _serialization_grain_size = grain_size; }
+    inline std::size_t serializationGrainSize() const { return _serialization_grain_size; }
+
+    /// Calls 'fun(JournalEntry&)' on every versioned value of the scene (see addons::VersionedValue) changed since 'version', from the earliest
+    /// change to the latest, each once. Costs the number of values changed, whatever the size of the scene. A consumer keeps its own version,
+    /// taking JournalEntry::CurrentVersion() before each pass, so any number of consumers follow the same changes independently.
+    /// Must be called from the thread running the scene, outside of its update cycle.
+    template <typename Function>
+    inline void forEachChangeSince(std::uint64_t version, Function&& fun) const { _change_journal->forEachChangeSince(version, std::forward<Function>(fun)); }
+
+    /// Creates a new GameObject in the scene, returning a reference to it, so it can immediatly be modified.
+    /// Structural changes made while an update phase is running (adding objects, removing objects, and attaching behaviours to objects already in the scene)
+    /// are queued, and applied in order once that phase ends, before the next phase starts. An object added during a phase can be set up as usual,
+    /// but will only take part in the update cycle (and have onStart called, if the scene has started) from the next phase onwards.
+    /// Changes made by systems running in a parallel stage (see setWorkerCount) are buffered per system, and queued in the stage's schedule
+    /// order once it ends, so neither their order nor the ids of the objects added depend on thread timing. Objects those systems add are
+    /// only placed in storage then, and have a null object_id() until the stage ends.
+	GameObject& addGameObject();
+
+    /// Spawns 'count' new objects, each holding a default constructed behaviour of every type in 'prefab', and returns their ids.
+    /// 'init(GameObject&, std::size_t index)' is then called on each object, in order, to set it up, before any of them joins the scene.
+    /// Storage for the whole batch is reserved up front, every object goes straight into its final archetype, systems are tested once for
+    /// the batch (rather than once per object and behaviour), and onStart, if the scene has started, is called on the whole batch once it
+    /// has joined. Inside an update phase the batch is deferred like addGameObject, joining the scene as a whole once the phase ends. The ids
+    /// returned to a system running in a parallel stage are null, as its objects get their ids when the stage ends.
+    template <typename... BehaviourTypes, typename Initializer = NoPrefabInit>
+    std::vector<GameObject::id> spawnBatch(std::size_t count, Prefab<BehaviourTypes...> prefab, Initializer&& init = Initializer());
+
+    /// Checks if an object with the provided id exists in the scene (id can fetched from a GameObject via the method object_id()).
+    /// Constant time. Ids of removed objects are never valid again, even if a new object is later created in their place.
+    bool hasGameObject(GameObject::id index) const;
+
+    /// Fetches a reference to the gameobject with the provided id in the scene. Constant time.
+    /// The reference remains valid until the object is removed from the scene.
+    GameObject& refGameObject(GameObject::id index) throw(std::invalid_argument);
+
+    /// Removes GameObject with id index from the scene, deleting it and it's contained behaviours.
+    /// Keep in mind that Scene guarantees that Object/Behaviour deletion will ONLY happen in between Update Cycle callbacks
+    /// what this means, for example, is that it's safe to delete objects at any time in those callbacks.
+    /// In a behaviour, on the 'onPreUpdate', 'onUpdate', 'onPostUpdate' calls, if you call removeGameObject (or GameObject::Destroy, which is equivalent)
+    /// then you can be sure that the object will only actually be deleted after that run cycle callback itself is called on every other GameObject.
+    void removeGameObject(GameObject::id index);
+
+
+    /// Adds a System to the Scene. The System is built inplace within the scene itself.
+    /// A System can be any class that derives from System.hpp.
+    /// Only one System of each type may reside inside a Scene. If a second one is added, the method will have no effect.
+	template <typename SystemSubType, typename... Args>
+    void attachSystem(Args&&... args);
+
+    /// Checks if the Scene has a System of the specified type (non-polymorphic, only accounts for systems of the exact type provided)
+    template <typename SystemSubType>
+	bool hasSystem() const;
+
+    /// Non-polymorphically fetches a reference to a contained System in the Scene.
+    /// Throws an exception if no such system is present.
+    template <typename SystemSubType>
+	SystemSubType& refSystem() throw(std::invalid_argument);
+
+    /// Points of the update cycle at which queued events are delivered (see setEventFlushPoints).
+    enum EventFlushPoint : unsigned {
+        FlushBeforePreUpdate = 1u << 0,
+        FlushAfterPreUpdate = 1u << 1,
+        FlushAfterUpdate = 1u << 2,
+        FlushAfterPostUpdate = 1u << 3
+    };
+
+    /// Queues an event, to be broadcast at the next flush point, instead of right away (see BroadcastEvent). Safe to call from any thread.
+    /// Events are queued contiguously per type, and delivered in bulk: every listener gets one call to HandleBatch (see ListensTo.hpp) with all the
+    /// events of the type queued since the last flush, in order. Events queued while a flush is delivering, whatever their type, wait for the next
+    /// flush, so handlers queueing further events can't make a flush run on indefinitely.
+    /// Events queued for single objects through GameObject::QueueEvent are delivered at the same points.
+    template <typename EventType>
+    void QueueEvent(const EventType& event);
+
+    /// Sets the points of the update cycle at which queued events are delivered, as a combination of EventFlushPoint values.
+    /// Defaults to flushing after each of the three phases. With no flush points, queued events are only delivered by calls to flushEvents.
+    inline void setEventFlushPoints(unsigned flush_points) { _event_flush_points = flush_points; }
+    inline unsigned eventFlushPoints() const { return _event_flush_points; }
+
+    /// Delivers every queued event, one event type at a time. Has no effect if called while a flush is already delivering.
+    void flushEvents();
+
+    /// Posts an event from any thread, including ones outside of the scene's thread pool, without taking any lock: the event is copied into the
+    /// scene's lock free ingress (see EventIngress.hpp), drained at the start of the next RunUpdateCycle into the queues of QueueEvent, and
+    /// delivered right after, before the pre-update phase.
+    /// Returns false, dropping the event, if the ingress is full; the caller decides whether to retry, coalesce or drop (see eventIngressStats).
+    template <typename EventType>
+    bool PostEvent(const EventType& event);
+    /// Posts an event for the listeners of a single object, waking it when delivered, as GameObject::QueueEvent does.
+    template <typename EventType>
+    bool PostEvent(GameObject::id target, const EventType& event);
+
+    /// Depth, peak depth, and the number of events posted, drained and rejected through PostEvent so far.
+    inline EventIngressStats eventIngressStats() const { return _event_ingress->stats(); }
+
+    /// Sets how many posted events the ingress can hold between two cycles (rounded up to a power of two, EventIngress::default_capacity by
+    /// default). Events already posted are queued first. Must not be called while other threads may be posting.
+    void setEventIngressCapacity(std::size_t capacity);
+
+    /// Triggers an event through all Behaviours and Systems that use the ListenTo<EventType> addon, in no particular order.
+    /// Costs O(listeners): the scene keeps its behaviours listed per type, and only visits the types deriving from ListenTo<EventType>.
+    /// Sleeping objects receive broadcast events without waking up.
+    /// Safe to call from systems running in parallel (see setWorkerCount), the listeners being called on the calling thread.
+    template <typename EventType>
+	void BroadcastEvent(const EventType& event);
+
+    // Private members of Scene contained in header
+    #include "_priv/Scene_priv.hpp"
+};
+}
+#include "_impl/Scene_impl.hpp"
+
+#endif
@@ -0,0 +1,246 @@
+#include "ember/core/Behaviour.hpp"
+#include "ember/core/BehaviourHooks.hpp"
+#include <algorithm>
+#include <type_traits>
+
+namespace ember {
+/// Implementation of template methods for Game Object
+template <typename BehaviourSubType, typename... Args>
+GameObject& GameObject::withBehaviour(Args&&... args) {
+    auto behaviour = std::allocate_shared<BehaviourSubType>(PoolAllocator<BehaviourSubType>(), std::forward<Args>(args)...);
+    static_cast<Behaviour&>(*behaviour)._overridden_hooks = BehaviourHooks::OverriddenBy<BehaviourSubType>();
+    AddBehaviour(BehaviourType::Id<BehaviourSubType>(), std::move(behaviour));
+	return *this;
+}
+
+template <typename BehaviourSubType>
+bool GameObject::hasBehaviour() const {
+    return _behaviour_mask.test(BehaviourType::Id<BehaviourSubType>());
+}
+
+template <typename BehaviourSubType>
+BehaviourSubType& GameObject::refBehaviour() throw(std::invalid_argument) {
+    auto type_id = BehaviourType::Id<BehaviourSubType>();
+    if (!_behaviour_mask.test(type_id)) {
+        throw std::invalid_argument("GameObject::refBehaviour - Behaviour " + std::string(typeid(BehaviourSubType).name()) + " not present in GameObject");
+    }
+    return *(static_cast<BehaviourSubType*>(BehaviourAt(type_id)));
+}
+
+template <typename BehaviourSubType>
+const BehaviourSubType& GameObject::refBehaviour() const throw(std::invalid_argument) {
+    auto type_id = BehaviourType::Id<BehaviourSubType>();
+    if (!_behaviour_mask.test(type_id)) {
+        throw std::invalid_argument("GameObject::refBehaviour - Behaviour " + std::string(typeid(BehaviourSubType).name()) + " not present in GameObject");
+    }
+    return *(static_cast<const BehaviourSubType*>(BehaviourAt(type_id)));
+}
+
+template <typename BehaviourSubType>
+std::weak_ptr<BehaviourSubType> GameObject::getBehaviour() {
+    auto type_id = BehaviourType::Id<BehaviourSubType>();
+    if (_behaviour_mask.test(type_id)) {
+        return std::static_pointer_cast<BehaviourSubType>(_behaviours[_behaviour_mask.rank(type_id)].behaviour);
+    }
+    return std::weak_ptr<BehaviourSubType>();
+}
+
+template <typename BehaviourSubType>
+std::weak_ptr<const BehaviourSubType> GameObject::getBehaviour() const {
+    auto type_id = BehaviourType::Id<BehaviourSubType>();
+    if (_behaviour_mask.test(type_id)) {
+        return std::static_pointer_cast<const BehaviourSubType>(_behaviours[_behaviour_mask.rank(type_id)].behaviour);
+    }
+    return std::weak_ptr<const BehaviourSubType>();
+}
+
+template <typename BehaviourSubType>
+std::vector<std::weak_ptr<BehaviourSubType>> GameObject::getBehaviours() {
+    SubtypeRegistry& registry = SubtypeRegistry::For<BehaviourSubType>();
+    ResolveSubtypes(registry);
+    std::vector<std::weak_ptr<BehaviourSubType>> output;
+    registry.Derived(_behaviour_mask).forEach([this, &registry, &output](BehaviourTypeId type_id) {
+        const auto& behaviour = _behaviours[_behaviour_mask.rank(type_id)].behaviour;
+        output.push_back(std::shared_ptr<BehaviourSubType>(behaviour, registry.Cast<BehaviourSubType>(behaviour.get(), type_id)));
+    });
+    return output;
+}
+
+template <typename BehaviourSubType>
+std::vector<std::weak_ptr<const BehaviourSubType>> GameObject::getBehaviours() const {
+    SubtypeRegistry& registry = SubtypeRegistry::For<BehaviourSubType>();
+    ResolveSubtypes(registry);
+    std::vector<std::weak_ptr<const BehaviourSubType>> output;
+    registry.Derived(_behaviour_mask).forEach([this, &registry, &output](BehaviourTypeId type_id) {
+        const auto& behaviour = _behaviours[_behaviour_mask.rank(type_id)].behaviour;
+        output.push_back(std::shared_ptr<const BehaviourSubType>(behaviour, registry.Cast<const BehaviourSubType>(behaviour.get(), type_id)));
+    });
+    return output;
+}
+
+template <typename BehaviourSubType>
+bool GameObject::hasBehaviours() const {
+    SubtypeRegistry& registry = SubtypeRegistry::For<BehaviourSubType>();
+    ResolveSubtypes(registry);
+    return registry.AnyDerived(_behaviour_mask);
+}
+
+template <typename BehaviourSubType, typename Function>
+void GameObject::forEachBehaviour(Function&& fun) {
+    SubtypeRegistry& registry = SubtypeRegistry::For<BehaviourSubType>();
+    ResolveSubtypes(registry);
+    registry.Derived(_behaviour_mask).forEach([this, &registry, &fun](BehaviourTypeId type_id) {
+        fun(*registry.Cast<BehaviourSubType>(BehaviourAt(type_id), type_id));
+    });
+}
+
+template <typename BehaviourSubType, typename Function>
+void GameObject::forEachBehaviour(Function&& fun) const {
+    SubtypeRegistry& registry = SubtypeRegistry::For<BehaviourSubType>();
+    ResolveSubtypes(registry);
+    registry.Derived(_behaviour_mask).forEach([this, &registry, &fun](BehaviourTypeId type_id) {
+        fun(*registry.Cast<const BehaviourSubType>(BehaviourAt(type_id), type_id));
+    });
+}
+
+template <typename EventType>
+void GameObject::CastEvent(const EventType& event) {
+    if (_sleeping) {
+        Wake();
+    }
+    DeliverEvent(event);
+}
+
+template <typename EventType>
+void GameObject::DeliverEvent(const EventType& event) {
+    // Listener types are resolved once per event type (see SubtypeRegistry.hpp), so finding the listeners is a mask intersection
+    forEachBehaviour<addons::ListensTo<EventType>>([&event](addons::ListensTo<EventType>& listener) { listener.Handle(event); });
+}
+
+struct GameObject::SerializedCacheBase {
+    virtual ~SerializedCacheBase() = default;
+    // Serialization cycle the cache was filled in, or last found valid in
+    std::uint64_t cycle = 0;
+};
+
+template <typename SerializableType>
+struct GameObject::SerializedCacheSub : public GameObject::SerializedCacheBase {
+    struct Responsible {
+        Behaviour* behaviour;
+        addons::SerializableInto<SerializableType>* serializable;
+    };
+    std::shared_ptr<SerializableType> cached_data;
+    std::vector<Responsible> behaviours_responsible;
+};
+
+template <typename SerializableType>
+GameObject::SerializedCacheSub<SerializableType>* GameObject::ValidSerializationCache(SerializationCaches& caches, bool partial) {
+    auto found = caches.find(std::type_index(typeid(SerializableType)));
+    if (found == caches.end()) {
+        return nullptr;
+    }
+    auto cache = static_cast<SerializedCacheSub<SerializableType>*>(found->second.get());
+    const auto cycle = CurrentSerializationCycle();
+    if (cache->cycle == cycle) {
+        return cache;
+    }
+    // First use in this cycle. Changes pushed since the cache was filled invalidate it, and only behaviours that never reported a change
+    // are asked through IsSerializationDirty
+    bool valid = _serialization_changed_cycle.load(std::memory_order_relaxed) <= cache->cycle;
+    for (auto responsible = cache->behaviours_responsible.begin(); valid && responsible != cache->behaviours_responsible.end(); ++responsible) {
+        valid = responsible->behaviour->_reports_serialization_changes ||
+            !responsible->serializable->IsSerializationDirty(cache->cached_data);
+    }
+    if (!valid) {
+        caches.erase(found);
+        return nullptr;
+    }
+    cache->cycle = cycle;
+    if (partial) {
+        // Nothing changed since the previous partial serialization
+        cache->cached_data = nullptr;
+    }
+    return cache;
+}
+
+template <typename SerializableType>
+GameObject::SerializedCacheSub<SerializableType>& GameObject::NewSerializationCache(SerializationCaches& caches) {
+    using Serializable = addons::SerializableInto<SerializableType>;
+    auto cache = new SerializedCacheSub<SerializableType>();
+    caches[std::type_index(typeid(SerializableType))].reset(cache);
+    cache->cycle = CurrentSerializationCycle();
+    SubtypeRegistry& registry = SubtypeRegistry::For<Serializable>();
+    ResolveSubtypes(registry);
+    registry.Derived(_behaviour_mask).forEach([this, &registry, cache](BehaviourTypeId type_id) {
+        auto behaviour = BehaviourAt(type_id);
+        cache->behaviours_responsible.push_back({ behaviour, registry.Cast<Serializable>(behaviour, type_id) });
+    });
+    return *cache;
+}
+
+template <typename SerializableType>
+bool GameObject::SerializeInto(SerializableType& into) {
+    static_assert(std::is_copy_assignable<SerializableType>::value,
+        "GameObject::SerializeInto - The type serialized into must be copy assignable, as the cached serialization is copied into 'into'");
+    auto serialized = SerializeShared<SerializableType>();
+    if (!serialized) {
+        return false;
+    }
+    into = *serialized;
+    return true;
+}
+
+template <typename SerializableType>
+bool GameObject::PartialSerializeInto(SerializableType& into) {
+    static_assert(std::is_copy_assignable<SerializableType>::value,
+        "GameObject::PartialSerializeInto - The type serialized into must be copy assignable, as the cached serialization is copied into 'into'");
+    auto serialized = PartialSerializeShared<SerializableType>();
+    if (!serialized) {
+        return false;
+    }
+    into = *serialized;
+    return true;
+}
+
+template <typename SerializableType>
+std::shared_ptr<const SerializableType> GameObject::SerializeShared() {
+    static_assert(std::is_default_constructible<SerializableType>::value,
+        "GameObject::SerializeShared - The type serialized into must be default constructible, as behaviours serialize into a new object");
+    SerializationCachesGuard guard(*this);
+    if (auto cache = ValidSerializationCache<SerializableType>(_serialization_cache, false)) {
+        return cache->cached_data;
+    }
+    auto& cache = NewSerializationCache<SerializableType>(_serialization_cache);
+    if (cache.behaviours_responsible.empty()) {
+        return nullptr;
+    }
+    auto serialized = std::make_shared<SerializableType>();
+    for (const auto& responsible : cache.behaviours_responsible) {
+        responsible.serializable->SerializeInto(*serialized);
+    }
+    cache.cached_data = serialized;
+    return serialized;
+}
+
+template <typename SerializableType>
+std::shared_ptr<const SerializableType> GameObject::PartialSerializeShared() {
+    static_assert(std::is_default_constructible<SerializableType>::value,
+        "GameObject::PartialSerializeShared - The type serialized into must be default constructible, as behaviours serialize into a new object");
+    SerializationCachesGuard guard(*this);
+    if (auto cache = ValidSerializationCache<SerializableType>(_partial_serialization_cache, true)) {
+        return cache->cached_data;
+    }
+    auto& cache = NewSerializationCache<SerializableType>(_partial_serialization_cache);
+    auto serialized = std::make_shared<SerializableType>();
+    bool serialized_something = false;
+    for (const auto& responsible : cache.behaviours_responsible) {
+        auto serialized_component = responsible.serializable->PartialSerializeInto(*serialized);
+        serialized_something = serialized_something || serialized_component;
+    }
+    if (serialized_something) {
+        cache.cached_data = serialized;
+        return serialized;
+    }
+    return nullptr;
+}
+}
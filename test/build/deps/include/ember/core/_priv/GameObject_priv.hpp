@@ -0,0 +1,88 @@
+// File containing the private API and internal workings of a GameObject to avoid polluting the public API file of the Gameobject
+
+// Class private methods
+private:
+    struct SerializedCacheBase;
+    template <typename SerializableType> struct SerializedCacheSub;
+    using SerializationCaches = std::map<std::type_index, std::unique_ptr<SerializedCacheBase>>;
+
+    // Returns the cache of SerializableType in 'caches' if it's still valid, or null after dropping it. Checked once per serialization cycle: a
+    // partial cache found valid in a later cycle than the one it was filled in holds no changes
+    template <typename SerializableType>
+    SerializedCacheSub<SerializableType>* ValidSerializationCache(SerializationCaches& caches, bool partial);
+    // Creates an empty cache of SerializableType in 'caches', listing the behaviours responsible for it
+    template <typename SerializableType>
+    SerializedCacheSub<SerializableType>& NewSerializationCache(SerializationCaches& caches);
+    // Number of serialization cycles the scene went through
+    std::uint64_t CurrentSerializationCycle() const;
+    // Invalidates the serialization caches from the next serialization cycle on
+    void MarkSerializationChanged();
+    // Holds the lock of the serialization caches for its lifetime, so the object may be serialized from several threads at once
+    struct SerializationCachesGuard {
+        explicit SerializationCachesGuard(GameObject& object);
+        ~SerializationCachesGuard();
+        GameObject& object;
+    };
+
+    // Attaches the behaviour to the object, or queues the attachment on the scene if it's deferring structural changes
+    void AddBehaviour(BehaviourTypeId type_id, std::shared_ptr<Behaviour> behaviour);
+    void AttachBehaviour(BehaviourTypeId type_id, std::shared_ptr<Behaviour> behaviour);
+
+    // Resolves the types of the object's behaviours not yet known to the registry
+    void ResolveSubtypes(SubtypeRegistry& registry) const;
+
+    // Behaviour of the type with the provided id, which must be present in the object
+    inline Behaviour* BehaviourAt(BehaviourTypeId type_id) const { return _behaviours[_behaviour_mask.rank(type_id)].behaviour.get(); }
+
+    // Calls the event handlers of the object's listeners, without waking it up
+    template <typename EventType>
+    void DeliverEvent(const EventType& event);
+
+    // The update cycle hooks of behaviours are dispatched by the Scene, only to the behaviours overriding them
+    void onStart();
+    void onEnd();
+
+// Class Variables
+private:
+    GameObject::id _id;
+    bool _hasStarted{ false };
+    bool _hasEnded{ false };
+    // Set when the object was added to the scene during an update phase, and is waiting for the phase to end to take part in the cycle
+    bool _pending_addition{ false };
+    // Set when the object was removed from the scene during an update phase, and is waiting for the phase to end to be destroyed
+    std::atomic<bool> _pending_removal{ false };
+    // Set while the object sleeps. Its behaviours are out of the scene's dispatch lists, and its id out of the systems' iterated sets
+    bool _sleeping = false;
+    // Set while a wake of the object is queued on the scene, so it's only queued once however many times the object is woken during a phase
+    std::atomic<bool> _pending_wake{ false };
+    std::size_t _next_behaviour_index = 0;
+    struct BehaviourEntry {
+        BehaviourTypeId type_id;
+        std::shared_ptr<Behaviour> behaviour;
+    };
+    // Behaviours sorted by type id, so the position of each behaviour is the rank of its type id in the mask.
+    // The storage comes from pools shared by every object, so spawning and destroying objects reuses it instead of going to the heap
+    std::vector<BehaviourEntry, PoolAllocator<BehaviourEntry>> _behaviours;
+    BehaviourMask _behaviour_mask;
+    bool _behaviours_changed = false;
+    // Types of the behaviours attached since the object was last filtered through the scene systems
+    BehaviourMask _changed_behaviour_types;
+    bool _filtered_through_systems = false;
+    // Location of the object in the scene's archetype storage, if enabled. Null while the object isn't stored in any archetype
+    class Archetype* _archetype = nullptr;
+    std::size_t _archetype_row = 0;
+
+    // Set while the object is in the scene's snapshot dirty set, and once it was part of a delta snapshot
+    std::atomic<bool> _snapshot_listed{ false };
+    bool _snapshot_sent = false;
+
+    SerializationCaches _serialization_cache;
+    SerializationCaches _partial_serialization_cache;
+    // One past the serialization cycle in which the object's serialization last changed (see Behaviour::MarkSerializationDirty). Caches filled before
+    // then are invalid, which is found when they're next used, so objects that don't change cost nothing per cycle
+    std::atomic<std::uint64_t> _serialization_changed_cycle{ 0 };
+    std::atomic<bool> _serialization_caches_locked{ false };
+
+    // Weak pointer to the scene the gameobject is attached to. If the gameobject exists
+    // The scene WILL exist
+    class Scene* _parent_scene = nullptr;
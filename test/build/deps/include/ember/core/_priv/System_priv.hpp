@@ -0,0 +1,54 @@
+// Class private methods
+private:
+    static sys::FilterMasks InexactFilterMasks() {
+        sys::FilterMasks masks;
+        masks.exact = false;
+        return masks;
+    }
+
+    // Decides if the system runs on the update cycle about to start, 'stagger' being the phase (in [0, 1) of its period) to start its clock at
+    void AdvanceTickClock(double deltaT, double stagger);
+
+    // Called by the scene as the system is attached, before any object is filtered through it. Whatever the system needs from the scene
+    // is resolved here, rather than on its first update, which may run alongside other systems
+    virtual void BindToScene() {}
+
+    // Query index of the scene for the types in 'required', through which TypedSystems reach their objects' behaviours
+    const QueryIndex& SceneQueryIndex(const BehaviourMask& required);
+    // Calls 'fun(row_begin, row_end)' over the rows in [0, row_count), in parallel chunks if the system opted into parallel iteration
+    void ForEachRowRange(std::size_t row_count, const std::function<void(std::size_t, std::size_t)>& fun);
+
+    // Fills 'archetypes' with the scene's archetypes holding the objects that pass the filter. Returns false, leaving it empty, if the scene
+    // has no archetype storage or the filter is not exact, as the archetypes can't tell which objects pass it then
+    bool MatchingArchetypes(std::vector<const Archetype*>& archetypes) const;
+    template <typename... BehaviourTypes, typename Function, std::size_t... Indices>
+    static void StreamChunk(const Archetype::Chunk& chunk, const std::size_t* columns, Function& fun, std::index_sequence<Indices...>);
+
+    bool PassesFilter(const GameObject& object) const;
+    void FilterGameObject(GameObject& object);
+
+    // Calls 'fun' on every managed object, in parallel if enabled, and removes the ids of no longer existing objects
+    void ForEachManagedObject(const std::function<void(GameObject&)>& fun);
+
+// Class Variables
+private:
+    // Weak pointer to the scene the gameobject is attached to. If the system exists
+    // the scene WILL exist.
+    class ember::Scene* _parent_scene = nullptr;
+    SystemFilter _filter_fun;
+    sys::FilterMasks _filter_masks;
+    // Last filter pass of the scene that tested an object against this system, so a system indexed under several types is tested once
+    std::size_t _filter_pass = 0;
+    sys::SystemAccess _access;
+    std::size_t _parallel_grain_size = 0;
+    // Ids of the sleeping objects filtered into the system, kept out of '_managed_objects' until they wake up
+    SlotSet _sleeping_objects;
+
+    // Milliseconds between runs, 0 to run on every update cycle
+    double _tick_period = 0;
+    bool _tick_clock_started = false;
+    double _tick_clock = 0;
+    double _elapsed_since_tick = 0;
+    // Set by AdvanceTickClock for the current update cycle
+    bool _ticking = true;
+    double _tick_delta = 0;
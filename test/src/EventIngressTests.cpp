@@ -0,0 +1,124 @@
+#include <stdexcept>
+#include <vector>
+#include "ember/core/EventIngress.hpp"
+#include "Tests.hpp"
+
+using namespace ember;
+
+namespace {
+
+struct Tick {
+    int value;
+};
+
+// Copying fails for events built with 'fail' set, as posting copies the event into the ring
+struct FailingCopy {
+    explicit FailingCopy(bool fail) : fail(fail) {}
+    FailingCopy(const FailingCopy& other) : fail(other.fail) {
+        if (fail) {
+            throw std::runtime_error("FailingCopy");
+        }
+    }
+    bool fail;
+};
+
+void CollectTick(void* event, SlotHandle, void* context) {
+    static_cast<std::vector<int>*>(context)->push_back(static_cast<Tick*>(event)->value);
+}
+
+void CountFailingCopy(void*, SlotHandle, void* context) {
+    (*static_cast<int*>(context))++;
+}
+
+int TestWrapsAround() {
+    int failures = 0;
+    EventIngress ingress(4);
+    std::vector<int> drained;
+    int next = 0;
+    // Three events per lap never fill the ring, but move every position across its end several times
+    for (int lap = 0; lap < 5; lap++) {
+        for (int event = 0; event < 3; event++) {
+            EMBER_CHECK(ingress.Post(SlotHandle(), Tick{next++}, &CollectTick));
+        }
+        EMBER_CHECK(ingress.Drain(&drained) == 3);
+    }
+    EMBER_CHECK(drained.size() == 15);
+    for (std::size_t position = 0; position < drained.size(); position++) {
+        EMBER_CHECK(drained[position] == static_cast<int>(position));
+    }
+    return failures;
+}
+
+int TestRejectsWhenFull() {
+    int failures = 0;
+    EventIngress ingress(3);
+    EMBER_CHECK(ingress.stats().capacity == 4);
+    for (int event = 0; event < 4; event++) {
+        EMBER_CHECK(ingress.Post(SlotHandle(), Tick{event}, &CollectTick));
+    }
+    EMBER_CHECK(!ingress.Post(SlotHandle(), Tick{4}, &CollectTick));
+    EMBER_CHECK(!ingress.Post(SlotHandle(), Tick{5}, &CollectTick));
+    auto stats = ingress.stats();
+    EMBER_CHECK(stats.rejected == 2);
+    EMBER_CHECK(stats.posted == 4);
+    EMBER_CHECK(stats.depth == 4);
+    std::vector<int> drained;
+    EMBER_CHECK(ingress.Drain(&drained) == 4);
+    EMBER_CHECK((drained == std::vector<int>{0, 1, 2, 3}));
+    // Draining frees the cells for the next lap
+    EMBER_CHECK(ingress.Post(SlotHandle(), Tick{6}, &CollectTick));
+    EMBER_CHECK(ingress.stats().rejected == 2);
+    return failures;
+}
+
+int TestThrowingCopyPublishesEmptyCell() {
+    int failures = 0;
+    EventIngress ingress(4);
+    bool threw = false;
+    try {
+        ingress.Post(SlotHandle(), FailingCopy(true), &CountFailingCopy);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    EMBER_CHECK(threw);
+    EMBER_CHECK(ingress.Post(SlotHandle(), FailingCopy(false), &CountFailingCopy));
+    int consumed = 0;
+    // The empty cell is moved past without being consumed, and doesn't hold up the event posted after it
+    EMBER_CHECK(ingress.Drain(&consumed) == 2);
+    EMBER_CHECK(consumed == 1);
+    EMBER_CHECK(ingress.stats().depth == 0);
+    return failures;
+}
+
+int TestStatsAfterDrain() {
+    int failures = 0;
+    EventIngress ingress(8);
+    std::vector<int> drained;
+    for (int event = 0; event < 5; event++) {
+        ingress.Post(SlotHandle(), Tick{event}, &CollectTick);
+    }
+    ingress.Drain(&drained);
+    for (int event = 0; event < 2; event++) {
+        ingress.Post(SlotHandle(), Tick{event}, &CollectTick);
+    }
+    auto stats = ingress.stats();
+    EMBER_CHECK(stats.posted == 7);
+    EMBER_CHECK(stats.drained == 5);
+    EMBER_CHECK(stats.depth == 2);
+    EMBER_CHECK(stats.peak_depth == 5);
+    ingress.Drain(&drained);
+    stats = ingress.stats();
+    EMBER_CHECK(stats.drained == 7);
+    EMBER_CHECK(stats.depth == 0);
+    // The peak is the highest depth found by a drain, not the current one
+    EMBER_CHECK(stats.peak_depth == 5);
+    EMBER_CHECK(stats.rejected == 0);
+    EMBER_CHECK(ingress.Drain(&drained) == 0);
+    return failures;
+}
+
+}
+
+int RunEventIngressTests() {
+    return TestWrapsAround() + TestRejectsWhenFull() + TestThrowingCopyPublishesEmptyCell() + TestStatsAfterDrain();
+}
@@ -0,0 +1,158 @@
+#include <cstdint>
+#include <map>
+#include <vector>
+#include "ember/core/Scene.hpp"
+#include "ember/core/Behaviour.hpp"
+#include "ember/core/GameObject.hpp"
+#include "ember/core/Snapshot.hpp"
+#include "Tests.hpp"
+
+using namespace ember;
+
+namespace {
+
+const std::uint16_t health_tag = 1;
+
+// Sends its full health, or the difference since it was last sent when marked dirty
+class SnapshotHealth : public Behaviour, public addons::SerializableInto<SnapshotWriter> {
+public:
+    void hit(int damage) {
+        health -= damage;
+        MarkSerializationDirty();
+    }
+
+    void SerializeInto(SnapshotWriter& writer) override {
+        writer.write(health);
+        sent = health;
+    }
+
+    bool PartialSerializeInto(SnapshotWriter& writer) override {
+        writer.write(health - sent);
+        sent = health;
+        return true;
+    }
+
+    int health = 100;
+    int sent = 100;
+};
+
+// Health of every object, as seen by a process fed only the snapshots
+using Replica = std::map<std::pair<std::uint32_t, std::uint32_t>, int>;
+
+// Applies the snapshot to the replica, returning the number of frames of each kind read, in SnapshotFrameKind order
+std::vector<std::size_t> Apply(const std::vector<std::uint8_t>& buffer, Replica& replica) {
+    std::vector<std::size_t> kinds(3, 0);
+    SnapshotReader reader(buffer);
+    if (reader.mode() == SnapshotMode::Full) {
+        replica.clear();
+    }
+    SnapshotFrame frame;
+    while (reader.next(frame)) {
+        auto key = std::make_pair(frame.object_id.index, frame.object_id.generation);
+        std::size_t offset = 0;
+        kinds[static_cast<std::size_t>(frame.kind)]++;
+        switch (frame.kind) {
+        case SnapshotFrameKind::Full:
+            replica[key] = frame.read<int>(offset);
+            break;
+        case SnapshotFrameKind::Partial:
+            replica[key] += frame.read<int>(offset);
+            break;
+        case SnapshotFrameKind::Tombstone:
+            replica.erase(key);
+            break;
+        }
+    }
+    return kinds;
+}
+
+Replica Expected(Scene& scene) {
+    Replica expected;
+    scene.forEachWithBehaviours<SnapshotHealth>([&expected](SnapshotHealth& health) {
+        auto id = health.game_object().object_id();
+        expected[std::make_pair(id.index, id.generation)] = health.health;
+    });
+    return expected;
+}
+
+int TestRoundTrip() {
+    int failures = 0;
+    SnapshotTags::Register<SnapshotHealth>(health_tag);
+    Scene scene;
+    std::vector<GameObject::id> ids;
+    for (int object = 0; object < 6; object++) {
+        ids.push_back(scene.addGameObject().withBehaviour<SnapshotHealth>().object_id());
+    }
+    scene.RunUpdateCycle(1);
+    std::vector<std::uint8_t> buffer;
+    Replica replica;
+
+    scene.refGameObject(ids[1]).refBehaviour<SnapshotHealth>().hit(30);
+    EMBER_CHECK(scene.writeSnapshot(buffer, SnapshotMode::Full) == 6);
+    auto kinds = Apply(buffer, replica);
+    EMBER_CHECK(kinds[static_cast<std::size_t>(SnapshotFrameKind::Full)] == 6);
+    EMBER_CHECK(replica == Expected(scene));
+    SnapshotReader reader(buffer);
+    SnapshotFrame frame;
+    EMBER_CHECK(reader.next(frame) && frame.tag == health_tag && frame.object_id == ids[0]);
+
+    // The first delta starts the tracking of changes, so it's written in full
+    EMBER_CHECK(scene.writeSnapshot(buffer, SnapshotMode::Delta) == 6);
+    Apply(buffer, replica);
+
+    scene.refGameObject(ids[2]).refBehaviour<SnapshotHealth>().hit(10);
+    scene.refGameObject(ids[2]).refBehaviour<SnapshotHealth>().hit(5);
+    scene.refGameObject(ids[4]).refBehaviour<SnapshotHealth>().hit(1);
+    auto added = scene.addGameObject().withBehaviour<SnapshotHealth>().object_id();
+    scene.refGameObject(added).refBehaviour<SnapshotHealth>().health = 50;
+    scene.removeGameObject(ids[5]);
+    EMBER_CHECK(scene.writeSnapshot(buffer, SnapshotMode::Delta) == 4);
+    kinds = Apply(buffer, replica);
+    EMBER_CHECK(kinds[static_cast<std::size_t>(SnapshotFrameKind::Partial)] == 2);
+    EMBER_CHECK(kinds[static_cast<std::size_t>(SnapshotFrameKind::Full)] == 1);
+    EMBER_CHECK(kinds[static_cast<std::size_t>(SnapshotFrameKind::Tombstone)] == 1);
+    EMBER_CHECK(replica.size() == 6);
+    EMBER_CHECK(replica == Expected(scene));
+
+    // Nothing changed since the last delta
+    EMBER_CHECK(scene.writeSnapshot(buffer, SnapshotMode::Delta) == 0);
+    return failures;
+}
+
+int TestRejectsMalformedSnapshots() {
+    int failures = 0;
+    Scene scene;
+    scene.addGameObject().withBehaviour<SnapshotHealth>();
+    std::vector<std::uint8_t> buffer;
+    scene.writeSnapshot(buffer, SnapshotMode::Full);
+    SnapshotFrame frame;
+
+    auto unknown_kind = buffer;
+    unknown_kind[SnapshotWriter::header_size + 10] = 3;
+    SnapshotReader unknown_kind_reader(unknown_kind);
+    bool threw = false;
+    try {
+        unknown_kind_reader.next(frame);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    EMBER_CHECK(threw);
+
+    auto truncated = buffer;
+    truncated.pop_back();
+    SnapshotReader truncated_reader(truncated);
+    threw = false;
+    try {
+        truncated_reader.next(frame);
+    } catch (const std::invalid_argument&) {
+        threw = true;
+    }
+    EMBER_CHECK(threw);
+    return failures;
+}
+
+}
+
+int RunSnapshotTests() {
+    return TestRoundTrip() + TestRejectsMalformedSnapshots();
+}
@@ -0,0 +1,19 @@
+#ifndef Ember_Tests_hpp
+#define Ember_Tests_hpp
+
+#include <iostream>
+
+// Checks are kept in release builds, where NDEBUG turns assert off. Each test counts its failed checks in a local 'failures'
+#define EMBER_CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " << #condition << std::endl; \
+            failures++; \
+        } \
+    } while (false)
+
+// Each suite returns the number of checks that failed
+int RunEventIngressTests();
+int RunSnapshotTests();
+
+#endif
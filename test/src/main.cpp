@@ -5,6 +5,7 @@
 
 #include "ember/core/System.hpp"
 #include "ember/core/Behaviour.hpp"
+#include "Tests.hpp"
 
 class LolBehaviour : public ember::Behaviour {
 public:
@@ -29,11 +30,11 @@ public:
     int _aquela_base;
 };
 
-class LaughSystem : public ember::System<ember::system::CompositeFilter<
-    ember::system::PolymorphicRequiresBehaviours<LolBehaviour>
-    ,ember::system::RequiresBehaviours<LelBehaviour>
-    ,ember::system::ExcludesBehaviours<HueHueHueBehaviour>
-    //,ember::system::PolymorphicExcludesBehaviours<LolBehaviour>
+class LaughSystem : public ember::System<ember::sys::CompositeFilter<
+    ember::sys::PolymorphicRequiresBehaviours<LolBehaviour>
+    ,ember::sys::RequiresBehaviours<LelBehaviour>
+    ,ember::sys::ExcludesBehaviours<HueHueHueBehaviour>
+    //,ember::sys::PolymorphicExcludesBehaviours<LolBehaviour>
     >> {
     virtual void onUpdate(double, ember::GameObject& object) override {
         if (object.hasBehaviour<LolBehaviour>()) {
@@ -50,27 +51,28 @@ int main(int, const char *[]){
     ember::Scene scene;
     scene.attachSystem<LaughSystem>();
     for (size_t i = 0; i < 1; i++) {
-        std::cout << scene.addGameObject().withBehaviour<LolBehaviour>(1000+i).object_id() << std::endl;
+        std::cout << scene.addGameObject().withBehaviour<LolBehaviour>(1000+i).object_id().index << std::endl;
     }
 
     for (size_t i = 0; i < 1; i++) {
-        std::cout << scene.addGameObject().withBehaviour<LelBehaviour>(2000+i).object_id() << std::endl;
+        std::cout << scene.addGameObject().withBehaviour<LelBehaviour>(2000+i).object_id().index << std::endl;
     }
 
     for (size_t i = 0; i < 1; i++) {
-        std::cout << scene.addGameObject().withBehaviour<LelBehaviour>(3000+i).withBehaviour<LolBehaviour>(3000+i).object_id() << std::endl;
+        std::cout << scene.addGameObject().withBehaviour<LelBehaviour>(3000+i).withBehaviour<LolBehaviour>(3000+i).object_id().index << std::endl;
     }
 
     for (size_t i = 0; i < 1; i++) {
-        std::cout << scene.addGameObject().withBehaviour<LolBehaviour>(4000+i).withBehaviour<HueHueHueBehaviour>(4000+i).object_id() << std::endl;
+        std::cout << scene.addGameObject().withBehaviour<LolBehaviour>(4000+i).withBehaviour<HueHueHueBehaviour>(4000+i).object_id().index << std::endl;
     }
 
     for (size_t i = 0; i < 1; i++) {
-        std::cout << scene.addGameObject().withBehaviour<LulBehaviour>(5000+i).withBehaviour<LelBehaviour>(5000+i).object_id() << std::endl;
+        std::cout << scene.addGameObject().withBehaviour<LulBehaviour>(5000+i).withBehaviour<LelBehaviour>(5000+i).object_id().index << std::endl;
     }
 
-    scene.onStart();
-    scene.onPreUpdate();
-    scene.onUpdate(3);
-    return 0;
+    scene.RunUpdateCycle(3);
+
+    int failures = RunEventIngressTests() + RunSnapshotTests();
+    std::cout << (failures == 0 ? "All tests passed" : "Some tests failed") << std::endl;
+    return failures == 0 ? 0 : 1;
 }